@@ -5,6 +5,13 @@
  * separating it from the Arduino-specific .ino file.
  * It now initializes and coordinates the persistent BLE and WiFi/MQTT tasks,
  * pinning them to the same core to prevent radio hardware conflicts.
+ * Handles single-character Serial debug commands for the UI profiler.
+ * The UI theme (standard/lite) can be switched from Serial; it is stored in NVS and applied on reboot.
+ * Serial 'b' runs the QSPI panel throughput benchmark.
+ * Serial 'c' runs the 3-point touch calibration, 'x' clears it.
+ * Preferences is opened before the display so NVS-backed UI settings are read correctly.
+ * Starts the battery monitor and publishes its readings to Home Assistant from the HA loop.
+ * Starts the power profile; the HA loop publishes the runtime estimate and applies its MQTT keepalive.
  */
 
 #include "app.h"
@@ -16,6 +23,13 @@
 #include <Preferences.h>
 #include <WiFi.h>
 #include "home_assistant.h"
+#include "ui_profiler.h"
+#include "ui_theme.h"
+#include "touch_calib.h"
+#include "battery_monitor.h"
+#include "power_profile.h"
+
+#define HA_BATTERY_PUBLISH_MS 60000 // Battery sensors in HA; the on-screen label updates on its own
 
 Preferences preferences;
 
@@ -26,6 +40,9 @@ extern TaskHandle_t ble_task_handle; // Defined in ble_client.cpp
 // --- FreeRTOS Task for HA Loop ---
 void ha_loop_task(void *pvParameters) {
     Serial.println("HA MQTT loop task started.");
+    uint32_t last_battery_publish = 0;
+    bool battery_published = false;
+    const power_profile_t* applied_profile = NULL;
     for (;;) {
         if (WiFi.status() != WL_CONNECTED) {
             Serial.println("WiFi disconnected. Attempting to reconnect...");
@@ -33,7 +50,24 @@ void ha_loop_task(void *pvParameters) {
             vTaskDelay(pdMS_TO_TICKS(5000));
             continue;
         }
+        const power_profile_t* profile = power_profile_current();
+        if (profile != applied_profile) {
+            ha_set_mqtt_keepalive(profile->mqtt_keepalive_s);
+            applied_profile = profile;
+        }
         mqtt.loop();
+
+        battery_state_t battery;
+        if (mqtt.isConnected() && (!battery_published || millis() - last_battery_publish >= HA_BATTERY_PUBLISH_MS) &&
+            battery_monitor_get(&battery)) {
+            ha_publish_battery(battery.percent, battery.rest_mv / 1000.0f);
+            power_status_t power;
+            if (power_profile_get_status(&power) && power.runtime_min != POWER_RUNTIME_UNKNOWN) {
+                ha_publish_battery_runtime(power.runtime_min);
+            }
+            last_battery_publish = millis();
+            battery_published = true;
+        }
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
@@ -46,10 +80,15 @@ void ha_loop_task(void *pvParameters) {
 void app_init() {
     Serial.println("Initializing main application...");
 
+    // Open NVS first: the UI reads presets/theme and touch reads its calibration during init
+    preferences.begin("shotStopper", false);
+    touch_calib_load();
+
     lcd_lvgl_Init();
     lcd_bl_pwm_bsp_init(BRIGHTNESS_HIGH);
+    battery_monitor_init();
+    power_profile_init(); // After the backlight: its load estimate feeds the battery compensation
     encoder_init();
-    preferences.begin("shotStopper", false);
 
     // Initialize BLE client task (creates the persistent task)
     ble_client_task_init();
@@ -87,3 +126,32 @@ void app_init() {
 
     Serial.println("Application initialization complete.");
 }
+
+// Single-character debug commands from the Serial monitor:
+//   p = dump UI profile, o = toggle profiler overlay, r = reset profiler,
+//   l = lit-pixel/render stats per screen, t = switch theme (reboots),
+//   b = panel throughput benchmark, c = calibrate touch, x = clear touch calibration
+static void toggle_theme_and_restart() {
+    int8_t mode = preferences.getChar(UI_THEME_NVS_KEY, UI_THEME_DEFAULT);
+    int8_t next = (mode == UI_THEME_LITE) ? UI_THEME_STANDARD : UI_THEME_LITE;
+    preferences.putChar(UI_THEME_NVS_KEY, next);
+    Serial.printf("Theme set to %s, restarting...\n", next == UI_THEME_LITE ? "lite" : "standard");
+    delay(100);
+    ESP.restart();
+}
+
+void app_poll_serial() {
+    while (Serial.available() > 0) {
+        switch (Serial.read()) {
+            case 'p': ui_profiler_request_dump(); break;
+            case 'o': ui_profiler_request_overlay_toggle(); break;
+            case 'r': ui_profiler_request_reset(); break;
+            case 'l': ui_profiler_request_screen_stats(); break;
+            case 't': toggle_theme_and_restart(); break;
+            case 'b': lcd_panel_benchmark_request(); break;
+            case 'c': touch_calib_request(); break;
+            case 'x': touch_calib_request_clear(); break;
+            default: break;
+        }
+    }
+}
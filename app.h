@@ -1,6 +1,7 @@
 /*
  * Main application header.
  * Declares the main initialization function.
+ * Declares the Serial debug command handler.
  */
 
 #ifndef APP_H
@@ -11,6 +12,7 @@ extern "C" {
 #endif
 
 void app_init(void);
+void app_poll_serial(void);
 
 #ifdef __cplusplus
 }
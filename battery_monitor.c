@@ -0,0 +1,270 @@
+/*
+ * Battery monitor implementation.
+ *
+ * The ADC continuous driver is started only for one burst of
+ * BATTERY_OVERSAMPLE conversions per period and stopped again, so the DMA,
+ * its interrupt and the driver's power-management lock are idle in between
+ * (light sleep keeps working). The raw average is converted with the eFuse
+ * curve-fitting scheme (line fitting or a nominal scale as fallbacks).
+ *
+ * Under load the cell sags by load x internal resistance, so the reading is
+ * corrected by the power profile's load estimate (screen state, backlight,
+ * radios) before it is filtered and looked up in an open-circuit discharge table. The table
+ * replaces the old linear 3.0-4.2 V mapping, which showed ~60 % for a cell
+ * resting at 3.73 V (~20 % left).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_idf_version.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "battery_monitor.h"
+#include "lvgl_display.h"   // update_battery_status()
+
+static const char *TAG = "battery";
+
+#define BATTERY_ADC_GPIO 1                 // GPIO1, behind a 100k/100k divider
+#define BATTERY_DIVIDER_RATIO 2
+#define BATTERY_ADC_ATTEN ADC_ATTEN_DB_12  // ~0-3.1 V at the pin
+#define BATTERY_SAMPLE_HZ 20000            // Conversion rate during a burst
+#define BATTERY_OVERSAMPLE 64              // Conversions averaged per reading (~3 ms burst)
+#define BATTERY_FILTER_SHIFT 2             // EMA weight of a new reading: 1/4
+#define BATTERY_TASK_STACK 3072
+#define BATTERY_TASK_PRIORITY 1
+// Load compensation: rest voltage = measured + load x internal resistance,
+// with the calibration values from battery_monitor.h
+
+#define BATTERY_FRAME_BYTES (BATTERY_OVERSAMPLE * SOC_ADC_DIGI_RESULT_BYTES)
+
+// Open-circuit voltage vs. remaining capacity for a typical 1S Li-ion/LiPo cell
+static const struct {
+    uint16_t mv;
+    uint8_t percent;
+} DISCHARGE_TABLE[] = {
+    {4200, 100}, {4150, 95}, {4110, 90}, {4080, 85}, {4020, 80}, {3980, 75},
+    {3950, 70},  {3910, 65}, {3870, 60}, {3850, 55}, {3840, 50}, {3820, 45},
+    {3800, 40},  {3790, 35}, {3770, 30}, {3750, 25}, {3730, 20}, {3710, 15},
+    {3690, 10},  {3610, 5},  {3270, 0},
+};
+
+static adc_continuous_handle_t adc_handle = NULL;
+static adc_cali_handle_t cali_handle = NULL;
+static adc_channel_t adc_channel;
+static uint8_t frame[BATTERY_FRAME_BYTES];
+static volatile uint32_t period_ms = BATTERY_MONITOR_PERIOD_MS;
+// Until power_profile reports: screen on at full backlight
+static volatile uint16_t load_estimate_ma = BATTERY_LOAD_SCREEN_ON_MA + BATTERY_LOAD_BACKLIGHT_MAX_MA;
+static TaskHandle_t battery_task_handle = NULL;
+
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+static battery_state_t state;
+static int32_t filtered_mv_x16 = 0; // EMA state, 1/16 mV
+
+uint16_t battery_permille_from_mv(uint32_t mv)
+{
+    const int last = sizeof(DISCHARGE_TABLE) / sizeof(DISCHARGE_TABLE[0]) - 1;
+    if (mv >= DISCHARGE_TABLE[0].mv) return 1000;
+    if (mv <= DISCHARGE_TABLE[last].mv) return 0;
+    for (int i = 1; i <= last; i++)
+    {
+        if (mv >= DISCHARGE_TABLE[i].mv)
+        {
+            // Linear between the two surrounding points
+            uint32_t span_mv = DISCHARGE_TABLE[i - 1].mv - DISCHARGE_TABLE[i].mv;
+            uint32_t span = (DISCHARGE_TABLE[i - 1].percent - DISCHARGE_TABLE[i].percent) * 10;
+            return DISCHARGE_TABLE[i].percent * 10 + (uint16_t)(((mv - DISCHARGE_TABLE[i].mv) * span + span_mv / 2) / span_mv);
+        }
+    }
+    return 0;
+}
+
+uint8_t battery_percent_from_mv(uint32_t mv)
+{
+    return (uint8_t)((battery_permille_from_mv(mv) + 5) / 10);
+}
+
+static bool battery_cali_init(void)
+{
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t cfg = {
+        .unit_id = ADC_UNIT_1,
+        .chan = adc_channel,
+        .atten = BATTERY_ADC_ATTEN,
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+    };
+    if (adc_cali_create_scheme_curve_fitting(&cfg, &cali_handle) == ESP_OK)
+    {
+        ESP_LOGI(TAG, "ADC calibration: eFuse curve fitting");
+        return true;
+    }
+#endif
+#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t line_cfg = {
+        .unit_id = ADC_UNIT_1,
+        .atten = BATTERY_ADC_ATTEN,
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+    };
+    if (adc_cali_create_scheme_line_fitting(&line_cfg, &cali_handle) == ESP_OK)
+    {
+        ESP_LOGI(TAG, "ADC calibration: eFuse line fitting");
+        return true;
+    }
+#endif
+    ESP_LOGW(TAG, "No ADC calibration in eFuse, using the nominal scale");
+    return false;
+}
+
+// One oversampled burst. Returns the average raw code, or -1 on error.
+static int32_t battery_sample_raw(void)
+{
+    uint32_t sum = 0, count = 0;
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 2, 0)
+    // No adc_continuous_flush_pool(): the first frame may be left over from the previous burst
+    bool discard = true;
+#endif
+    if (adc_continuous_start(adc_handle) != ESP_OK) return -1;
+    while (count < BATTERY_OVERSAMPLE)
+    {
+        uint32_t len = 0;
+        if (adc_continuous_read(adc_handle, frame, sizeof(frame), &len, 100) != ESP_OK) break;
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 2, 0)
+        if (discard)
+        {
+            discard = false;
+            continue;
+        }
+#endif
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES)
+        {
+            adc_digi_output_data_t *p = (adc_digi_output_data_t *)&frame[i];
+            if (p->type2.channel != adc_channel) continue;
+            sum += p->type2.data;
+            count++;
+        }
+    }
+    adc_continuous_stop(adc_handle);
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
+    adc_continuous_flush_pool(adc_handle); // Next burst must not start with frames from this one
+#endif
+    return count ? (int32_t)(sum / count) : -1;
+}
+
+static void battery_update(int32_t raw)
+{
+    int pin_mv = 0;
+    if (!cali_handle || adc_cali_raw_to_voltage(cali_handle, raw, &pin_mv) != ESP_OK)
+    {
+        pin_mv = raw * 3100 / ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1);
+    }
+    uint32_t measured_mv = (uint32_t)pin_mv * BATTERY_DIVIDER_RATIO;
+
+    uint16_t load_ma = load_estimate_ma;
+    uint32_t rest_mv = measured_mv + (uint32_t)load_ma * BATTERY_INTERNAL_MOHM / 1000;
+
+    if (state.readings == 0)
+    {
+        filtered_mv_x16 = (int32_t)rest_mv << 4;
+    }
+    else
+    {
+        filtered_mv_x16 += (((int32_t)rest_mv << 4) - filtered_mv_x16) >> BATTERY_FILTER_SHIFT;
+    }
+    uint32_t filtered_mv = (uint32_t)((filtered_mv_x16 + 8) >> 4);
+    uint8_t percent = battery_percent_from_mv(filtered_mv);
+
+    bool changed;
+    taskENTER_CRITICAL(&state_lock);
+    changed = state.readings == 0 || percent != state.percent;
+    state.measured_mv = measured_mv;
+    state.rest_mv = filtered_mv;
+    state.load_ma = load_ma;
+    state.percent = percent;
+    state.readings++;
+    taskEXIT_CRITICAL(&state_lock);
+
+    ESP_LOGD(TAG, "raw %ld, %lu mV under %u mA -> %lu mV rest, %u%%", (long)raw,
+             (unsigned long)measured_mv, load_ma, (unsigned long)filtered_mv, percent);
+    if (changed) update_battery_status(percent); // Only wake the LVGL task when the label changes
+}
+
+static void battery_task(void *arg)
+{
+    for (;;)
+    {
+        int32_t raw = battery_sample_raw();
+        if (raw >= 0)
+        {
+            battery_update(raw);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "ADC burst failed");
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(period_ms)); // Woken early by a period change
+    }
+}
+
+void battery_monitor_init(void)
+{
+    if (adc_handle) return;
+
+    adc_unit_t unit;
+    ESP_ERROR_CHECK(adc_continuous_io_to_channel(BATTERY_ADC_GPIO, &unit, &adc_channel));
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
+        .max_store_buf_size = BATTERY_FRAME_BYTES * 2,
+#else
+        .max_store_buf_size = BATTERY_FRAME_BYTES, // At most one stale frame, dropped by the next burst
+#endif
+        .conv_frame_size = BATTERY_FRAME_BYTES,
+    };
+    ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_cfg, &adc_handle));
+
+    adc_digi_pattern_config_t pattern = {
+        .atten = BATTERY_ADC_ATTEN,
+        .channel = adc_channel,
+        .unit = unit,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = BATTERY_SAMPLE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+    ESP_ERROR_CHECK(adc_continuous_config(adc_handle, &dig_cfg));
+
+    state.calibrated = battery_cali_init();
+    ESP_LOGI(TAG, "Battery on GPIO%d (ADC1 ch%d), %d conversions every %lu ms",
+             BATTERY_ADC_GPIO, adc_channel, BATTERY_OVERSAMPLE, (unsigned long)period_ms);
+    xTaskCreate(battery_task, "battery", BATTERY_TASK_STACK, NULL, BATTERY_TASK_PRIORITY, &battery_task_handle);
+}
+
+bool battery_monitor_get(battery_state_t *out)
+{
+    taskENTER_CRITICAL(&state_lock);
+    *out = state;
+    taskEXIT_CRITICAL(&state_lock);
+    return out->readings > 0;
+}
+
+void battery_monitor_set_load_ma(uint16_t load_ma)
+{
+    load_estimate_ma = load_ma;
+}
+
+void battery_monitor_set_period_ms(uint32_t new_period_ms)
+{
+    if (new_period_ms == period_ms) return;
+    bool shorter = new_period_ms < period_ms;
+    period_ms = new_period_ms;
+    if (shorter && battery_task_handle) xTaskNotifyGive(battery_task_handle); // Sample now, then at the new rate
+}
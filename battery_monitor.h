@@ -0,0 +1,81 @@
+/*
+ * Header for the battery monitor.
+ *
+ * Samples the battery divider with the ADC continuous (DMA) driver from its
+ * own low-priority task: every period it takes one oversampled burst,
+ * converts it with the chip's eFuse calibration, compensates the voltage sag
+ * caused by the current load (the power profile's estimate) and maps the result to
+ * a percentage with a piecewise Li-ion discharge table. The UI label is
+ * updated through the mailbox; other tasks read the latest state.
+ */
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BATTERY_MONITOR_PERIOD_MS 5000 // Default sampling period
+
+// --- CALIBRATION: load model ---
+// Estimates, not measurements. Check them on the device (USB power meter for the
+// currents, rest vs. loaded voltage for the resistance) and override per build.
+// power_profile sums them into one load estimate, used both for its runtime
+// estimate and, through battery_monitor_set_load_ma(), for the sag compensation.
+#ifndef BATTERY_INTERNAL_MOHM
+#define BATTERY_INTERNAL_MOHM 150          // Cell + protection + wiring
+#endif
+#ifndef BATTERY_LOAD_SCREEN_ON_MA
+#define BATTERY_LOAD_SCREEN_ON_MA 80       // SoC + panel scanning at the normal refresh rate
+#endif
+#ifndef BATTERY_LOAD_SCREEN_AMBIENT_MA
+#define BATTERY_LOAD_SCREEN_AMBIENT_MA 40  // Panel idle mode, LVGL in low-power mode
+#endif
+#ifndef BATTERY_LOAD_SCREEN_OFF_MA
+#define BATTERY_LOAD_SCREEN_OFF_MA 30      // Panel asleep
+#endif
+#ifndef BATTERY_LOAD_BACKLIGHT_MAX_MA
+#define BATTERY_LOAD_BACKLIGHT_MAX_MA 110  // Extra at backlight duty 255
+#endif
+#ifndef BATTERY_LOAD_WIFI_MA
+#define BATTERY_LOAD_WIFI_MA 25            // Associated, modem sleep between beacons
+#endif
+#ifndef BATTERY_LOAD_BLE_SESSION_MA
+#define BATTERY_LOAD_BLE_SESSION_MA 15     // BLE connection open to the shotStopper
+#endif
+
+typedef struct {
+    uint32_t measured_mv; // Calibrated pin voltage x divider ratio, last burst (under load)
+    uint32_t rest_mv;     // Filtered, load-compensated cell voltage
+    uint16_t load_ma;     // Load estimate used for the compensation
+    uint8_t percent;      // From the discharge table
+    bool calibrated;      // eFuse calibration scheme in use
+    uint32_t readings;    // Bursts taken so far (0 = no data yet)
+} battery_state_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sets up the ADC, calibration and sampling task. Safe to call once at boot.
+void battery_monitor_init(void);
+
+// Copies the latest state. Returns false until the first reading is in.
+bool battery_monitor_get(battery_state_t *out);
+
+// Sampling period; the ambient screen stretches it to save wakeups.
+void battery_monitor_set_period_ms(uint32_t period_ms);
+
+// Current load estimate for the sag compensation (set by power_profile, any task).
+void battery_monitor_set_load_ma(uint16_t load_ma);
+
+// Discharge table lookup (rest voltage in mV -> 0..100 %).
+uint8_t battery_percent_from_mv(uint32_t mv);
+
+// Same lookup in 0.1 % steps, fine enough to follow the discharge slope.
+uint16_t battery_permille_from_mv(uint32_t mv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATTERY_MONITOR_H
@@ -6,13 +6,30 @@
  *
  *
  * Modified by planevina 2025-01-20
+ *
+ * Added a pulse-counter (PCNT) backend (KNOB_USE_PCNT): the peripheral counts
+ * and glitch-filters the encoder edges, and the CPU only runs on a step (limit
+ * watch point). Events are dispatched from a small task so callbacks still run
+ * in task context. The glitch filter only removes sub-13 us spikes, so contact
+ * bounce is dropped in the ISR: a step in the same direction as the previous one
+ * within KNOB_PCNT_DEBOUNCE_MS is ignored. The software decoder stays the default
+ * until KNOB_COMPARE_SOFTWARE runs on the device show PCNT missing fewer steps. KNOB_COMPARE_SOFTWARE keeps the 3 ms software decoder running
+ * silently next to it and logs the steps each decoder saw per spin.
+ * Each event carries a timestamp (iot_knob_get_event_time_ms): the time of the step
+ * for the software decoder; with PCNT, steps dispatched in one batch are spaced
+ * between the previous step and the last one the ISR saw.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "driver/gpio.h"
 #include "esp_attr.h"
+#include "esp_check.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/pulse_cnt.h"
 #include "bidi_switch_knob.h"
 
 static const char *TAG = "Knob";
@@ -20,6 +37,22 @@ static const char *TAG = "Knob";
 #define TICKS_INTERVAL 3
 #define DEBOUNCE_TICKS 2
 
+#ifndef KNOB_USE_PCNT
+#define KNOB_USE_PCNT 0 // 1 = hardware pulse counter, 0 = software sampling every TICKS_INTERVAL ms
+#endif
+#ifndef KNOB_PCNT_QUADRATURE
+#define KNOB_PCNT_QUADRATURE 0 // 0 = A pulses count right, B pulses left (as the software decoder), 1 = A/B quadrature
+#endif
+#define KNOB_PCNT_COUNTS_PER_STEP (KNOB_PCNT_QUADRATURE ? 4 : 1) // Counts per detent
+#define KNOB_PCNT_GLITCH_NS 10000 // Pulses shorter than this are filtered in hardware (max ~12.8 us on S3)
+#define KNOB_PCNT_DEBOUNCE_MS 4 // Same-direction steps closer than this are contact bounce
+#ifndef KNOB_COMPARE_SOFTWARE
+#define KNOB_COMPARE_SOFTWARE 0 // 1 = also run the software decoder (no callbacks) and log missed steps
+#endif
+#define KNOB_BURST_GAP_MS 300 // A spin ends after this long without steps
+#define KNOB_TASK_STACK 4096
+#define KNOB_TASK_PRIORITY 3
+
 #define KNOB_CHECK(a, str, ret_val)                               \
     if (!(a))                                                     \
     {                                                             \
@@ -48,6 +81,23 @@ typedef struct Knob
     uint8_t encoder_b_level;                        /*!< Encoder B phase current Level */
     knob_event_t event;                             /*!< Current event */
     int count_value;                                /*!< Knob count */
+    uint32_t event_time_ms;                         /*!< Time of the event being dispatched */
+    int sw_count;                                   /*!< Steps seen by the software decoder */
+#if KNOB_USE_PCNT
+    pcnt_unit_handle_t pcnt_unit;                   /*!< Hardware counter */
+    pcnt_channel_handle_t pcnt_chan[2];             /*!< Phase A/B channels */
+    int pcnt_pending;                               /*!< Steps counted by the ISR, not yet dispatched (atomic) */
+    uint32_t pcnt_last_ms;                          /*!< Time of the ISR's latest step (atomic) */
+    int64_t pcnt_step_us;                           /*!< Time of the last accepted step (ISR only) */
+    int pcnt_step_dir;                              /*!< Its direction, +1/-1 (ISR only) */
+    int pcnt_bounces;                               /*!< Steps dropped as bounce (atomic) */
+    uint32_t dispatched_ms;                         /*!< Time given to the last dispatched step */
+    int burst_pcnt_steps;                           /*!< Steps in the current spin (PCNT) */
+    int burst_sw_start;                             /*!< sw_count at the start of the spin */
+    int64_t burst_start_us;
+    int64_t burst_last_us;
+    uint32_t burst_max_rate;                        /*!< Peak steps/s in the current spin */
+#endif
     uint8_t (*hal_knob_level)(void *hardware_data); /*!< Get current level */
     void *encoder_a;                                /*!< Encoder A phase gpio number */
     void *encoder_b;                                /*!< Encoder B phase gpio number */
@@ -59,12 +109,20 @@ typedef struct Knob
 static knob_dev_t *s_head_handle = NULL;
 static esp_timer_handle_t s_knob_timer_handle;
 static bool s_is_timer_running = false;
+#if KNOB_USE_PCNT
+static TaskHandle_t s_knob_task_handle = NULL;
+#endif
 
 // 判定函数
 static void process_knob_channel(uint8_t current_level, uint8_t *prev_level,
                                  uint8_t *debounce_cnt, int *count_value,
                                  knob_event_t event, bool is_increment, knob_dev_t *knob)
 {
+#if KNOB_USE_PCNT
+    // Shadow decoder for comparison only: the PCNT path owns count_value and the callbacks
+    int shadow_count = 0;
+    count_value = &shadow_count;
+#endif
     if (current_level == 0)
     {
         if (current_level != *prev_level)
@@ -78,8 +136,12 @@ static void process_knob_channel(uint8_t current_level, uint8_t *prev_level,
         {
             *debounce_cnt = 0;
             *count_value += is_increment ? 1 : -1;
+            knob->sw_count += is_increment ? 1 : -1;
+#if !KNOB_USE_PCNT
             knob->event = event;
+            knob->event_time_ms = (uint32_t)(esp_timer_get_time() / 1000);
             CALL_EVENT_CB(event);
+#endif
         }
         else
             *debounce_cnt = 0;
@@ -111,6 +173,202 @@ static void knob_cb(void *args)
     }
 }
 
+#if KNOB_USE_PCNT
+// Runs when the counter hits +/- KNOB_PCNT_COUNTS_PER_STEP; the hardware has already
+// reset it to zero, so no edge is lost between steps.
+static bool IRAM_ATTR knob_pcnt_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    knob_dev_t *knob = (knob_dev_t *)user_ctx;
+    int64_t now_us = esp_timer_get_time();
+    int dir = edata->watch_point_value > 0 ? 1 : -1;
+    if (dir == knob->pcnt_step_dir && now_us - knob->pcnt_step_us < KNOB_PCNT_DEBOUNCE_MS * 1000)
+    {
+        __atomic_fetch_add(&knob->pcnt_bounces, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    knob->pcnt_step_us = now_us;
+    knob->pcnt_step_dir = dir;
+    // Time first, so a task that sees the step also sees a time at least as new
+    __atomic_store_n(&knob->pcnt_last_ms, (uint32_t)(now_us / 1000), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&knob->pcnt_pending, dir, __ATOMIC_SEQ_CST);
+    BaseType_t woken = pdFALSE;
+    if (s_knob_task_handle)
+    {
+        vTaskNotifyGiveFromISR(s_knob_task_handle, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+static void knob_pcnt_end_burst(knob_dev_t *knob)
+{
+    if (knob->burst_pcnt_steps == 0)
+        return;
+    int bounces = __atomic_exchange_n(&knob->pcnt_bounces, 0, __ATOMIC_RELAXED);
+#if KNOB_COMPARE_SOFTWARE
+    int sw_steps = knob->sw_count - knob->burst_sw_start;
+    ESP_LOGI(TAG, "Spin: %d steps (PCNT, %d bounces dropped), %d (software), software missed %d, %lld ms, peak %lu steps/s",
+             knob->burst_pcnt_steps, bounces, sw_steps, abs(knob->burst_pcnt_steps) - abs(sw_steps),
+             (knob->burst_last_us - knob->burst_start_us) / 1000, (unsigned long)knob->burst_max_rate);
+#else
+    ESP_LOGD(TAG, "Spin: %d steps, %d bounces dropped, peak %lu steps/s", knob->burst_pcnt_steps, bounces,
+             (unsigned long)knob->burst_max_rate);
+#endif
+    knob->burst_pcnt_steps = 0;
+}
+
+// Dispatches PCNT steps to the registered callbacks in task context.
+// Sleeps until a step arrives; the timeout only exists to close a spin for the stats.
+static void knob_task(void *arg)
+{
+    TickType_t wait = portMAX_DELAY;
+    while (1)
+    {
+        bool notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
+        int64_t now_us = esp_timer_get_time();
+        for (knob_dev_t *knob = s_head_handle; knob; knob = knob->next)
+        {
+            if (!notified)
+            {
+                knob_pcnt_end_burst(knob);
+                continue;
+            }
+            int steps = __atomic_exchange_n(&knob->pcnt_pending, 0, __ATOMIC_SEQ_CST);
+            if (steps == 0)
+                continue;
+            if (knob->burst_pcnt_steps == 0)
+            {
+                knob->burst_start_us = now_us;
+                knob->burst_sw_start = knob->sw_count - steps; // Software decoder may already have seen them
+                knob->burst_max_rate = 0;
+            }
+            else if (now_us > knob->burst_last_us)
+            {
+                uint32_t rate = (uint32_t)(abs(steps) * 1000000LL / (now_us - knob->burst_last_us));
+                if (rate > knob->burst_max_rate)
+                    knob->burst_max_rate = rate;
+            }
+            knob->burst_last_us = now_us;
+            knob->burst_pcnt_steps += steps;
+
+            // A batch would otherwise reach the callbacks with one timestamp (a 0 ms gap,
+            // which knob acceleration reads as the fastest possible spin): spread it
+            // between the previous step and the latest one counted by the ISR.
+            uint32_t last_ms = __atomic_load_n(&knob->pcnt_last_ms, __ATOMIC_RELAXED);
+            uint32_t prev_ms = knob->dispatched_ms;
+            if (knob->burst_pcnt_steps == steps || last_ms - prev_ms > KNOB_BURST_GAP_MS)
+                prev_ms = last_ms - KNOB_BURST_GAP_MS; // New spin: no previous step to space from
+            int n = abs(steps);
+            knob_event_t event = steps > 0 ? KNOB_RIGHT : KNOB_LEFT;
+            for (int i = 1; i <= n; i++)
+            {
+                knob->count_value += steps > 0 ? 1 : -1;
+                knob->event = event;
+                knob->event_time_ms = n == 1 ? last_ms : prev_ms + (last_ms - prev_ms) * i / n;
+                CALL_EVENT_CB(event);
+            }
+            knob->dispatched_ms = last_ms;
+        }
+        wait = notified ? pdMS_TO_TICKS(KNOB_BURST_GAP_MS) : portMAX_DELAY;
+    }
+}
+
+// Releases whatever knob_pcnt_init() managed to create; safe on a partial init
+static void knob_pcnt_deinit(knob_dev_t *knob)
+{
+    if (knob->pcnt_unit)
+    {
+        pcnt_unit_stop(knob->pcnt_unit);    // Fails harmlessly if it never started
+        pcnt_unit_disable(knob->pcnt_unit); // Likewise if it was never enabled
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (knob->pcnt_chan[i])
+        {
+            pcnt_del_channel(knob->pcnt_chan[i]);
+            knob->pcnt_chan[i] = NULL;
+        }
+    }
+    if (knob->pcnt_unit)
+    {
+        pcnt_del_unit(knob->pcnt_unit);
+        knob->pcnt_unit = NULL;
+    }
+}
+
+static esp_err_t knob_pcnt_init(knob_dev_t *knob, const knob_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -KNOB_PCNT_COUNTS_PER_STEP,
+        .high_limit = KNOB_PCNT_COUNTS_PER_STEP,
+    };
+    ESP_GOTO_ON_ERROR(pcnt_new_unit(&unit_config, &knob->pcnt_unit), err, TAG, "pcnt unit");
+
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = KNOB_PCNT_GLITCH_NS,
+    };
+    ESP_GOTO_ON_ERROR(pcnt_unit_set_glitch_filter(knob->pcnt_unit, &filter_config), err, TAG, "pcnt filter");
+
+#if KNOB_PCNT_QUADRATURE
+    pcnt_chan_config_t chan_a_config = {
+        .edge_gpio_num = config->gpio_encoder_a,
+        .level_gpio_num = config->gpio_encoder_b,
+    };
+    pcnt_chan_config_t chan_b_config = {
+        .edge_gpio_num = config->gpio_encoder_b,
+        .level_gpio_num = config->gpio_encoder_a,
+    };
+#else
+    pcnt_chan_config_t chan_a_config = {
+        .edge_gpio_num = config->gpio_encoder_a,
+        .level_gpio_num = -1,
+    };
+    pcnt_chan_config_t chan_b_config = {
+        .edge_gpio_num = config->gpio_encoder_b,
+        .level_gpio_num = -1,
+    };
+#endif
+    ESP_GOTO_ON_ERROR(pcnt_new_channel(knob->pcnt_unit, &chan_a_config, &knob->pcnt_chan[0]), err, TAG, "pcnt channel A");
+    ESP_GOTO_ON_ERROR(pcnt_new_channel(knob->pcnt_unit, &chan_b_config, &knob->pcnt_chan[1]), err, TAG, "pcnt channel B");
+    pcnt_channel_handle_t chan_a = knob->pcnt_chan[0];
+    pcnt_channel_handle_t chan_b = knob->pcnt_chan[1];
+
+#if KNOB_PCNT_QUADRATURE
+    // Standard x4 decoding; swap the encoder pins if the direction is reversed
+    pcnt_channel_set_edge_action(chan_a, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    pcnt_channel_set_level_action(chan_a, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    pcnt_channel_set_edge_action(chan_b, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+    pcnt_channel_set_level_action(chan_b, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+#else
+    // Same rule as the software decoder: rising edge on A = right, on B = left
+    pcnt_channel_set_edge_action(chan_a, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD);
+    pcnt_channel_set_edge_action(chan_b, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD);
+#endif
+
+    ESP_GOTO_ON_ERROR(pcnt_unit_add_watch_point(knob->pcnt_unit, KNOB_PCNT_COUNTS_PER_STEP), err, TAG, "pcnt watch +");
+    ESP_GOTO_ON_ERROR(pcnt_unit_add_watch_point(knob->pcnt_unit, -KNOB_PCNT_COUNTS_PER_STEP), err, TAG, "pcnt watch -");
+    pcnt_event_callbacks_t cbs = {
+        .on_reach = knob_pcnt_on_reach,
+    };
+    ESP_GOTO_ON_ERROR(pcnt_unit_register_event_callbacks(knob->pcnt_unit, &cbs, knob), err, TAG, "pcnt callbacks");
+
+    if (!s_knob_task_handle)
+    {
+        xTaskCreate(knob_task, "knob_task", KNOB_TASK_STACK, NULL, KNOB_TASK_PRIORITY, &s_knob_task_handle);
+    }
+
+    ESP_GOTO_ON_ERROR(pcnt_unit_enable(knob->pcnt_unit), err, TAG, "pcnt enable");
+    ESP_GOTO_ON_ERROR(pcnt_unit_clear_count(knob->pcnt_unit), err, TAG, "pcnt clear");
+    ESP_GOTO_ON_ERROR(pcnt_unit_start(knob->pcnt_unit), err, TAG, "pcnt start");
+
+    return ESP_OK;
+
+err:
+    knob_pcnt_deinit(knob);
+    return ret;
+}
+#endif
+
 knob_handle_t iot_knob_create(const knob_config_t *config)
 {
     KNOB_CHECK(NULL != config, "config pointer can't be NULL!", NULL)
@@ -134,9 +392,27 @@ knob_handle_t iot_knob_create(const knob_config_t *config)
 
     knob->event = KNOB_NONE;
 
+#if KNOB_USE_PCNT
+    ret = knob_pcnt_init(knob, config);
+    if (ESP_OK != ret)
+    {
+        free(knob);
+    }
+    KNOB_CHECK_GOTO(ESP_OK == ret, "pcnt init failed", _encoder_deinit);
+#endif
+
     knob->next = s_head_handle;
     s_head_handle = knob;
 
+#if KNOB_USE_PCNT
+    ESP_LOGI(TAG, "Iot Knob on PCNT (%s, glitch filter %d ns), encoder A:%d, encoder B:%d",
+             KNOB_PCNT_QUADRATURE ? "quadrature" : "A/B pulses", KNOB_PCNT_GLITCH_NS,
+             config->gpio_encoder_a, config->gpio_encoder_b);
+#if !KNOB_COMPARE_SOFTWARE
+    return (knob_handle_t)knob;
+#endif
+#endif
+
     if (!s_knob_timer_handle)
     {
         esp_timer_create_args_t knob_timer = {0};
@@ -167,6 +443,9 @@ esp_err_t iot_knob_delete(knob_handle_t knob_handle)
     esp_err_t ret = ESP_OK;
     KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
     knob_dev_t *knob = (knob_dev_t *)knob_handle;
+#if KNOB_USE_PCNT
+    knob_pcnt_deinit(knob);
+#endif
     ret = knob_gpio_deinit((int)(knob->usr_data));
     KNOB_CHECK(ESP_OK == ret, "knob deinit failed", ESP_FAIL);
     knob_dev_t **curr;
@@ -230,6 +509,13 @@ knob_event_t iot_knob_get_event(knob_handle_t knob_handle)
     return knob->event;
 }
 
+uint32_t iot_knob_get_event_time_ms(knob_handle_t knob_handle)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", 0);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    return knob->event_time_ms;
+}
+
 int iot_knob_get_count_value(knob_handle_t knob_handle)
 {
     KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
@@ -247,6 +533,15 @@ esp_err_t iot_knob_clear_count_value(knob_handle_t knob_handle)
 
 esp_err_t iot_knob_resume(void)
 {
+#if KNOB_USE_PCNT
+    for (knob_dev_t *knob = s_head_handle; knob; knob = knob->next)
+    {
+        pcnt_unit_start(knob->pcnt_unit);
+    }
+#if !KNOB_COMPARE_SOFTWARE
+    return ESP_OK;
+#endif
+#endif
     KNOB_CHECK(s_knob_timer_handle, "knob timer handle is invalid", ESP_ERR_INVALID_STATE);
     KNOB_CHECK(!s_is_timer_running, "knob timer is already running", ESP_ERR_INVALID_STATE);
 
@@ -258,6 +553,15 @@ esp_err_t iot_knob_resume(void)
 
 esp_err_t iot_knob_stop(void)
 {
+#if KNOB_USE_PCNT
+    for (knob_dev_t *knob = s_head_handle; knob; knob = knob->next)
+    {
+        pcnt_unit_stop(knob->pcnt_unit);
+    }
+#if !KNOB_COMPARE_SOFTWARE
+    return ESP_OK;
+#endif
+#endif
     KNOB_CHECK(s_knob_timer_handle, "knob timer handle is invalid", ESP_ERR_INVALID_STATE);
     KNOB_CHECK(s_is_timer_running, "knob timer is not running", ESP_ERR_INVALID_STATE);
 
@@ -96,6 +96,14 @@ extern "C"
      */
     knob_event_t iot_knob_get_event(knob_handle_t knob_handle);
 
+    /**
+     * @brief Get the time of the event being dispatched (call from the event callback)
+     *
+     * @param knob_handle A knob handle to register
+     * @return uint32_t Milliseconds since boot, same clock as millis()
+     */
+    uint32_t iot_knob_get_event_time_ms(knob_handle_t knob_handle);
+
     /**
      * @brief Get knob count value
      *
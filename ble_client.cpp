@@ -5,6 +5,9 @@
  * all BLE operations. Commands (connect, read, write, disconnect) are sent
  * to this task via a FreeRTOS queue, preventing resource conflicts with the
  * WiFi/MQTT task and improving stability.
+ * After a read/write the session lingers for the power profile's linger time (0 in
+ * both profiles for now, i.e. disconnect at once as before).
+ * target_weight is owned by the LVGL task; a weight read here is posted to the UI.
  */
 
 #include <Arduino.h>
@@ -13,6 +16,7 @@
 #include "lvgl_display.h"
 #include "app_events.h"
 #include "BLECommand.h"
+#include "power_profile.h"
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEScan.h>
@@ -63,7 +67,10 @@ class MyClientCallback : public BLEClientCallbacks {
 
 // --- Core BLE Functions ---
 bool connectToServer() {
-    if (connected) return true;
+    if (connected) {
+        update_ble_status(BLE_STATUS_CONNECTED); // Lingering session; send_ble_command() showed "connecting"
+        return true;
+    }
     update_ble_status(BLE_STATUS_CONNECTING);
 
     BLEScan* pScan = BLEDevice::getScan();
@@ -129,6 +136,11 @@ void disconnectFromServer() {
     update_ble_status(BLE_STATUS_DISCONNECTED);
 }
 
+// Ends a read/write: disconnects now, or leaves the session open for the task's linger wait
+static void finishSession() {
+    if (power_profile_current()->ble_linger_ms == 0) disconnectFromServer();
+}
+
 int8_t internal_read_weight() {
     if (connected && pRemoteCharacteristic && pRemoteCharacteristic->canRead()) {
         std::string value = pRemoteCharacteristic->readValue();
@@ -152,43 +164,46 @@ void ble_client_task(void *pvParameters) {
     Serial.println("BLE client task started.");
 
     while (true) {
-        if (xQueueReceive(bleCommandQueue, &cmd, portMAX_DELAY)) {
-            switch (cmd.type) {
-                case BLE_CONNECT:
-                    connectToServer();
-                    break;
-                case BLE_DISCONNECT:
-                    disconnectFromServer();
-                    break;
-                case BLE_READ_WEIGHT:
-                    if (connectToServer()) {
-                        int8_t weight = internal_read_weight();
-                        if (weight != -1) {
-                            target_weight = weight;
-                            update_display_value(target_weight);
-                            show_verification_checkmark();
-                        }
-                        disconnectFromServer();
+        uint32_t linger_ms = power_profile_current()->ble_linger_ms;
+        TickType_t wait = (connected && linger_ms > 0) ? pdMS_TO_TICKS(linger_ms) : portMAX_DELAY;
+        if (!xQueueReceive(bleCommandQueue, &cmd, wait)) {
+            Serial.printf("[%lu] BLE session idle, disconnecting.\n", millis());
+            disconnectFromServer();
+            continue;
+        }
+        switch (cmd.type) {
+            case BLE_CONNECT:
+                connectToServer();
+                break;
+            case BLE_DISCONNECT:
+                disconnectFromServer();
+                break;
+            case BLE_READ_WEIGHT:
+                if (connectToServer()) {
+                    int8_t weight = internal_read_weight();
+                    if (weight != -1) {
+                        update_display_value(weight); // The LVGL task adopts it as target_weight
+                        show_verification_checkmark();
                     }
-                    break;
-                case BLE_WRITE_WEIGHT:
-                    if (connectToServer()) {
-                        if (internal_write_weight(cmd.payload)) {
-                            int8_t read_value = internal_read_weight();
-                            if (read_value == cmd.payload) {
-                                target_weight = cmd.payload;
-                                update_display_value(target_weight);
-                                show_verification_checkmark();
-                            } else {
-                                update_ble_status(BLE_STATUS_FAILED);
-                            }
+                    finishSession();
+                }
+                break;
+            case BLE_WRITE_WEIGHT:
+                if (connectToServer()) {
+                    if (internal_write_weight(cmd.payload)) {
+                        int8_t read_value = internal_read_weight();
+                        if (read_value == cmd.payload) {
+                            // Already shown. Only confirm it if the knob hasn't moved on since
+                            if (cmd.payload == target_weight) show_verification_checkmark();
                         } else {
                             update_ble_status(BLE_STATUS_FAILED);
                         }
-                        disconnectFromServer();
+                    } else {
+                        update_ble_status(BLE_STATUS_FAILED);
                     }
-                    break;
-            }
+                    finishSession();
+                }
+                break;
         }
     }
 }
@@ -210,6 +225,8 @@ void ble_client_task_init() {
     );
 }
 
+bool ble_client_session_open() { return connected; }
+
 void send_ble_command(BLECommand command) {
     hide_verification_checkmark();
     update_ble_status(BLE_STATUS_CONNECTING);
@@ -4,6 +4,7 @@
  * Declares the functions for initializing the BLE client and interacting
  * with the target weight characteristic.
  * Added ble_perform_initial_read for boot-up sequence.
+ * Added ble_client_session_open() for the power estimate.
  */
 #ifndef BLE_CLIENT_H
 #define BLE_CLIENT_H
@@ -14,10 +15,11 @@
 #include <BLECommand.h>
 
 extern QueueHandle_t bleCommandQueue;
-extern int8_t target_weight; // Make the global variable accessible
+extern int8_t target_weight; // Make the global variable accessible (written on the LVGL task only)
 
 void ble_client_task_init();
 void send_ble_command(BLECommand command);
+bool ble_client_session_open(); // True while a (lingering) connection is up
 
 #endif // BLE_CLIENT_H
 
@@ -1,68 +1,222 @@
+/*
+ * CST816 touch controller driver.
+ *
+ * Uses the ESP-IDF I2C master bus/device API. Transfers use preallocated
+ * buffers (no malloc per write), retry on error and are counted for stats.
+ * With EXAMPLE_TOUCH_I2C_ASYNC the coordinate read can be queued and
+ * completes in the background; the ready callback is invoked from ISR context.
+ * With EXAMPLE_TOUCH_HW_GESTURES the controller's gesture engine is enabled and one
+ * gesture code is recorded per touch (see touch_track_gesture()).
+ */
 #include "cst816.h"
 #include "esp_err.h"
+#include "esp_log.h"
 #include "lcd_config.h"
 
-#define TEST_I2C_PORT I2C_NUM_0
+#define CST816_REG_STATUS 0x00  // Start of the gesture/points/X/Y block
+#define CST816_REG_MOTION_MASK 0xEC
+#define CST816_REG_IRQ_CTL 0xFA
+#define CST816_IRQ_EN_TOUCH  0x40  // Periodic IRQ while touched
+#define CST816_IRQ_EN_CHANGE 0x20  // IRQ on touch state change
+#define CST816_IRQ_EN_MOTION 0x10  // IRQ when a gesture is recognised
+#define CST816_READ_LEN   7
+#define CST816_WRITE_MAX  8     // Register + payload for configuration writes
 
-uint8_t I2C_writr_buff(uint8_t addr,uint8_t reg,uint8_t *buf,uint8_t len)
+static const char *TAG = "cst816";
+
+static i2c_master_bus_handle_t touch_bus = NULL;
+static i2c_master_dev_handle_t touch_dev = NULL;
+
+// Preallocated transfer buffers
+static uint8_t touch_reg = CST816_REG_STATUS;
+static uint8_t touch_rx[CST816_READ_LEN];
+static uint8_t touch_tx[CST816_WRITE_MAX];
+
+static touch_i2c_stats_t touch_stats = {0};
+static uint8_t touch_gesture = CST816_GESTURE_NONE;       // Recorded for the current/last touch
+static uint8_t touch_gesture_stale = CST816_GESTURE_NONE; // Register value left from an earlier touch
+static bool touch_down = false;
+
+#if EXAMPLE_TOUCH_I2C_ASYNC
+static volatile bool async_busy = false;
+static volatile bool async_ready = false;
+static volatile bool async_failed = false;
+static void (*async_ready_cb)(void) = NULL;
+#endif
+
+static esp_err_t touch_write_reg(uint8_t reg, const uint8_t *buf, uint8_t len)
 {
-  uint8_t ret;
-  uint8_t *pbuf = (uint8_t*)malloc(len+1);
-  pbuf[0] = reg;
-  for(uint8_t i = 0; i<len; i++)
-  {
-    pbuf[i+1] = buf[i];
+  if (len + 1 > CST816_WRITE_MAX) return ESP_ERR_INVALID_SIZE;
+  touch_tx[0] = reg;
+  for (uint8_t i = 0; i < len; i++) {
+    touch_tx[i + 1] = buf[i];
   }
-  ret = i2c_master_write_to_device(TEST_I2C_PORT,addr,pbuf,len+1,1000);
-  free(pbuf);
-  pbuf = NULL;
-  return ret;
+  return i2c_master_transmit(touch_dev, touch_tx, len + 1, EXAMPLE_TOUCH_I2C_TIMEOUT_MS);
 }
-uint8_t I2C_read_buff(uint8_t addr,uint8_t reg,uint8_t *buf,uint8_t len)
+
+// Blocking register read with retries
+static esp_err_t touch_read_block(void)
 {
-  uint8_t ret;
-  ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,&reg,1,buf,len,1000);
+  esp_err_t ret = ESP_FAIL;
+  for (int attempt = 0; attempt <= EXAMPLE_TOUCH_I2C_RETRIES; attempt++) {
+    if (attempt > 0) touch_stats.retries++;
+    ret = i2c_master_transmit_receive(touch_dev, &touch_reg, 1, touch_rx, CST816_READ_LEN, EXAMPLE_TOUCH_I2C_TIMEOUT_MS);
+    if (ret == ESP_OK) break;
+    if (ret == ESP_ERR_TIMEOUT) touch_stats.timeouts++;
+  }
+  touch_stats.reads++;
+  if (ret != ESP_OK) touch_stats.errors++;
   return ret;
 }
-uint8_t I2C_master_write_read_device(uint8_t addr,uint8_t *writeBuf,uint8_t writeLen,uint8_t *readBuf,uint8_t readLen)
+
+// The gesture register keeps its last code until the engine recognises a new one, so a
+// tap after a swipe still reads the swipe. The code present at the press is ignored until
+// it changes; the first other non-zero code read while down (or at the lift) is kept
+// until the next press.
+static void touch_track_gesture(uint8_t code, bool down)
 {
-  uint8_t ret;
-  ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,writeBuf,writeLen,readBuf,readLen,1000);
-  return ret;
+  if (down && !touch_down) {
+    touch_gesture = CST816_GESTURE_NONE;
+    touch_gesture_stale = code;
+  } else if ((down || touch_down) && code != touch_gesture_stale) {
+    touch_gesture_stale = CST816_GESTURE_NONE; // Changed once: a repeat of the same code is new
+    if (touch_gesture == CST816_GESTURE_NONE) touch_gesture = code;
+  }
+  touch_down = down;
 }
+
+// Decodes touch_rx; returns 1 and the raw coordinates if a finger is down
+static uint8_t touch_decode(const uint8_t *data, uint16_t *x, uint16_t *y)
+{
+  touch_track_gesture(data[1], data[2] != 0);
+  if (data[2] == 0) return 0;
+  // Raw controller coordinates; orientation/calibration is touch_transform()'s job
+  *x = ((uint16_t)(data[3] & 0x0f) << 8) + (uint16_t)data[4];
+  *y = ((uint16_t)(data[5] & 0x0f) << 8) + (uint16_t)data[6];
+  return 1;
+}
+
+#if EXAMPLE_TOUCH_I2C_ASYNC
+static bool IRAM_ATTR touch_trans_done_cb(i2c_master_dev_handle_t dev, const i2c_master_event_data_t *evt, void *arg)
+{
+  async_failed = evt->event != I2C_EVENT_DONE;
+  async_busy = false;
+  async_ready = true;
+  if (async_ready_cb) async_ready_cb();
+  return false;
+}
+#endif
+
 void Touch_Init(void)
 {
-  i2c_config_t conf = 
-  {
-    .mode = I2C_MODE_MASTER,
-    .sda_io_num = EXAMPLE_PIN_NUM_TOUCH_SDA,         // Configure the GPIO of the SDA
-    .scl_io_num = EXAMPLE_PIN_NUM_TOUCH_SCL,         // Configure GPIO for SCL
-    .sda_pullup_en = GPIO_PULLUP_ENABLE,
-    .scl_pullup_en = GPIO_PULLUP_ENABLE,
-    .master = {.clk_speed = 300 * 1000,},  // Select a frequency for the project
-    .clk_flags = 0,          // Optionally, use the I2C SCLK SRC FLAG * flag to select the I2C source clock
+  const i2c_master_bus_config_t bus_conf = {
+    .i2c_port = I2C_NUM_0,
+    .sda_io_num = (gpio_num_t)EXAMPLE_PIN_NUM_TOUCH_SDA,
+    .scl_io_num = (gpio_num_t)EXAMPLE_PIN_NUM_TOUCH_SCL,
+    .clk_source = I2C_CLK_SRC_DEFAULT,
+    .glitch_ignore_cnt = 7,
+    .intr_priority = 0,
+    .trans_queue_depth = EXAMPLE_TOUCH_I2C_ASYNC ? 2 : 0, // Non-zero enables async transfers
+    .flags = {
+      .enable_internal_pullup = 1,
+    },
   };
-  ESP_ERROR_CHECK(i2c_param_config(TEST_I2C_PORT, &conf));
-  ESP_ERROR_CHECK(i2c_driver_install(TEST_I2C_PORT, conf.mode,0,0,0));
+  ESP_ERROR_CHECK(i2c_new_master_bus(&bus_conf, &touch_bus));
+
+  const i2c_device_config_t dev_conf = {
+    .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+    .device_address = EXAMPLE_TOUCH_ADDR,
+    .scl_speed_hz = EXAMPLE_TOUCH_I2C_HZ,
+  };
+  ESP_ERROR_CHECK(i2c_master_bus_add_device(touch_bus, &dev_conf, &touch_dev));
 
   uint8_t data = 0x00;
-  I2C_writr_buff(EXAMPLE_TOUCH_ADDR,0x00,&data,1); //Switch to normal mode
+  if (touch_write_reg(0x00, &data, 1) != ESP_OK) { //Switch to normal mode
+    touch_stats.errors++;
+    ESP_LOGW(TAG, "Touch controller did not ACK the mode write");
+  }
+
+#if EXAMPLE_TOUCH_HW_GESTURES
+  uint8_t motion_mask = 0x00; // Single swipes only; no continuous swipes or double click
+  uint8_t irq_ctl = CST816_IRQ_EN_TOUCH | CST816_IRQ_EN_CHANGE | CST816_IRQ_EN_MOTION;
+  if (touch_write_reg(CST816_REG_MOTION_MASK, &motion_mask, 1) != ESP_OK ||
+      touch_write_reg(CST816_REG_IRQ_CTL, &irq_ctl, 1) != ESP_OK) {
+    touch_stats.errors++;
+    ESP_LOGW(TAG, "Could not configure the gesture engine");
+  }
+#endif
+
+#if EXAMPLE_TOUCH_I2C_ASYNC
+  const i2c_master_event_callbacks_t cbs = {
+    .on_trans_done = touch_trans_done_cb,
+  };
+  ESP_ERROR_CHECK(i2c_master_register_event_callbacks(touch_dev, &cbs, NULL));
+#endif
+  ESP_LOGI(TAG, "Touch I2C at %d kHz, %s", EXAMPLE_TOUCH_I2C_HZ / 1000, EXAMPLE_TOUCH_I2C_ASYNC ? "async" : "blocking");
 }
+
 uint8_t getTouch(uint16_t *x,uint16_t *y)
 {
-  uint8_t GetNum = 0;
-  uint8_t data[7] = {0};
-  I2C_read_buff(EXAMPLE_TOUCH_ADDR,0x00,data,7);
-  GetNum = data[2];
-  if(GetNum)
-  {
-    uint16_t raw_x = ((uint16_t)(data[3] & 0x0f)<<8) + (uint16_t)data[4];
-    uint16_t raw_y = ((uint16_t)(data[5] & 0x0f)<<8) + (uint16_t)data[6];
-
-    // *** NEW: Apply 180-degree rotation transformation to touch coordinates ***
-    *x = EXAMPLE_LCD_H_RES - 1 - raw_x;
-    *y = EXAMPLE_LCD_V_RES - 1 - raw_y;
-    return 1;
+#if EXAMPLE_TOUCH_I2C_ASYNC
+  // With callbacks registered every transfer on the device is async; block (not spin) on this one
+  if (!touchReadAsync()) return 0;
+  if (i2c_master_bus_wait_all_done(touch_bus, EXAMPLE_TOUCH_I2C_TIMEOUT_MS) != ESP_OK) {
+    touch_stats.timeouts++;
+    return 0;
+  }
+  int8_t ret = touchGetAsyncResult(x, y);
+  if (ret < 0) touch_stats.timeouts++;
+  return ret > 0 ? 1 : 0;
+#else
+  if (touch_read_block() != ESP_OK) return 0;
+  return touch_decode(touch_rx, x, y);
+#endif
+}
+
+#if EXAMPLE_TOUCH_I2C_ASYNC
+void touchSetReadyCallback(void (*cb)(void))
+{
+  async_ready_cb = cb;
+}
+
+bool touchReadAsync(void)
+{
+  if (async_busy) return true; // Already in flight
+  async_busy = true;
+  async_ready = false;
+  esp_err_t ret = i2c_master_transmit_receive(touch_dev, &touch_reg, 1, touch_rx, CST816_READ_LEN, -1);
+  touch_stats.reads++;
+  if (ret != ESP_OK) {
+    async_busy = false;
+    touch_stats.errors++;
+    return false;
   }
-  return 0;
+  return true;
+}
+
+int8_t touchGetAsyncResult(uint16_t *x, uint16_t *y)
+{
+  if (!async_ready) return -1;
+  async_ready = false;
+  if (async_failed) {
+    touch_stats.errors++;
+    return 0;
+  }
+  return touch_decode(touch_rx, x, y);
+}
+#endif
+
+uint8_t getTouchGesture(void)
+{
+  return touch_gesture;
+}
+
+uint32_t getTouchReadCount(void)
+{
+  return touch_stats.reads;
+}
+
+void getTouchStats(touch_i2c_stats_t *out)
+{
+  *out = touch_stats;
 }
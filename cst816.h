@@ -1,16 +1,44 @@
 #ifndef CST816_H
 #define CST816_H
-#include "driver/i2c.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/i2c_master.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif 
 
+// Gesture register (0x01) codes
+#define CST816_GESTURE_NONE         0x00
+#define CST816_GESTURE_SWIPE_UP     0x01
+#define CST816_GESTURE_SWIPE_DOWN   0x02
+#define CST816_GESTURE_SWIPE_LEFT   0x03
+#define CST816_GESTURE_SWIPE_RIGHT  0x04
+#define CST816_GESTURE_SINGLE_CLICK 0x05
+#define CST816_GESTURE_DOUBLE_CLICK 0x0B
+#define CST816_GESTURE_LONG_PRESS   0x0C
+
+typedef struct {
+    uint32_t reads;     // Coordinate reads issued
+    uint32_t errors;    // Reads/writes that failed after all retries
+    uint32_t retries;   // Extra attempts made by blocking reads
+    uint32_t timeouts;  // Attempts that hit EXAMPLE_TOUCH_I2C_TIMEOUT_MS
+} touch_i2c_stats_t;
+
 void Touch_Init(void);
 
 uint8_t getTouch(uint16_t *x,uint16_t *y);
+uint8_t getTouchGesture(void);    // Gesture code recorded for the current/last touch
+uint32_t getTouchReadCount(void); // I2C coordinate reads since boot
+void getTouchStats(touch_i2c_stats_t *out);
+
+// Async reads (EXAMPLE_TOUCH_I2C_ASYNC): queue a read, get notified from ISR context,
+// then collect it. touchGetAsyncResult() returns -1 while pending, else like getTouch().
+void touchSetReadyCallback(void (*cb)(void));
+bool touchReadAsync(void);
+int8_t touchGetAsyncResult(uint16_t *x, uint16_t *y);
 
 #ifdef __cplusplus
 }
 #endif
-#endif
\ No newline at end of file
+#endif
@@ -10,14 +10,23 @@
  * turning the knob for 1 second.
  * Calls reset_inactivity_timer() on encoder turn.
  * Corrected ble_write_timer definition (removed static).
+ * Target weight changes are accelerated by knob speed (knob_accel) and clamped.
+ * The knob callbacks only push (delta, timestamp) events into the mailbox knob
+ * ring, so no UI, logging or blocking calls run in the knob's timer/task context.
+ * The LVGL task feeds the ring to an LVGL encoder input device (ui_encoder); the
+ * focused widget of the active screen's group handles each detent.
+ * Detents are stamped with the driver's step time, not the dispatch time, and
+ * encoder_set_sleep_wakeup() arms the encoder pins as light-sleep wakeup sources
+ * for the ambient screen.
  */
 
 #include <Arduino.h>
-#include <lvgl.h> // Include LVGL FIRST
 #include "encoder.h"
 #include "ble_client.h" // Include BLE client for write_target_weight
-#include "lvgl_display.h" // Include display header AFTER lvgl.h
 #include "bidi_switch_knob.h" // Make sure this is the correct header name
+#include "ui_mailbox.h" // Knob event ring
+#include <driver/gpio.h>
+#include <esp_sleep.h>
 
 
 // External variable for the target weight (used by Shot Stopper screen)
@@ -31,11 +40,6 @@ TimerHandle_t ble_write_timer = NULL;
 #define ENCODER_PIN_A 8
 #define ENCODER_PIN_B 7
 
-// Forward declaration for the HA screen encoder handler
-// extern void ha_ui_handle_encoder_turn(int8_t direction); // Declared in lvgl_display.h
-// Forward declaration for the HA screen timer reset
-// extern void ha_ui_reset_deselection_timer(); // Declared in lvgl_display.h
-
 // Callback function for the BLE write timer
 // This function is called 1 second *after* the last encoder turn
 static void ble_write_timer_callback(TimerHandle_t xTimer) {
@@ -43,47 +47,34 @@ static void ble_write_timer_callback(TimerHandle_t xTimer) {
     write_target_weight(target_weight); // Call the actual BLE write function
 }
 
-// Callback for left rotation
+// Knob callbacks: run in the knob's esp_timer callback (or PCNT knob task), so they
+// only record the detent. LVGL reads the ring through its encoder input device (ui_encoder).
+// arg is the knob handle; PCNT batches carry spaced step times instead of one dispatch time.
 static void knob_left_cb(void* arg, void* data) {
-    reset_inactivity_timer(); // Reset brightness/inactivity timer
-
-    lv_obj_t* current_screen = lv_scr_act(); // Get the currently active screen
-
-    if (current_screen == screen_shot_stopper) {
-        target_weight--;
-        Serial.printf("Encoder left (Shot Stopper). New target weight: %d\n", target_weight);
-        hide_verification_checkmark();
-        update_display_value(target_weight); // Update UI immediately
-
-        // Don't write yet, just reset the debounce timer
-        if (ble_write_timer != NULL) {
-            xTimerReset(ble_write_timer, portMAX_DELAY); // Reset timer to 1 second
-        }
-    } else if (current_screen == screen_ha) {
-        Serial.println("Encoder left (HA Screen).");
-        ha_ui_handle_encoder_turn(-1); // Pass direction -1 for left turn
-    }
+    ui_mailbox_push_knob(-1, iot_knob_get_event_time_ms(arg));
 }
 
-// Callback for right rotation
 static void knob_right_cb(void* arg, void* data) {
-     reset_inactivity_timer(); // Reset brightness/inactivity timer
-
-     lv_obj_t* current_screen = lv_scr_act(); // Get the currently active screen
-
-    if (current_screen == screen_shot_stopper) {
-        target_weight++;
-        Serial.printf("Encoder right (Shot Stopper). New target weight: %d\n", target_weight);
-        hide_verification_checkmark();
-        update_display_value(target_weight); // Update UI immediately
+    ui_mailbox_push_knob(1, iot_knob_get_event_time_ms(arg));
+}
 
-        // Don't write yet, just reset the debounce timer
-        if (ble_write_timer != NULL) {
-            xTimerReset(ble_write_timer, portMAX_DELAY); // Reset timer to 1 second
+// The knob isn't sampled or counted in light sleep, so the pins have to wake the chip.
+// GPIO wakeup is level triggered: armed at a fixed level, a pin resting at that level
+// (a detent can leave either phase low) would wake the chip at once, every time. Each
+// pin is armed at the opposite of its current level, so only a change wakes it. The
+// edge that wakes the chip may not be counted.
+void encoder_set_sleep_wakeup(bool enable) {
+    const gpio_num_t pins[] = {(gpio_num_t)ENCODER_PIN_A, (gpio_num_t)ENCODER_PIN_B};
+    if (enable) {
+        for (gpio_num_t pin : pins) {
+            gpio_wakeup_enable(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+        }
+        esp_sleep_enable_gpio_wakeup();
+    } else {
+        for (gpio_num_t pin : pins) {
+            gpio_wakeup_disable(pin);
         }
-    } else if (current_screen == screen_ha) {
-         Serial.println("Encoder right (HA Screen).");
-         ha_ui_handle_encoder_turn(1); // Pass direction 1 for right turn
+        esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO); // The encoder is the only GPIO source
     }
 }
 
@@ -1,6 +1,6 @@
 /*
  * Header for the rotary encoder module.
- * Declares the initialization function.
+ * Declares the initialization function and the light-sleep wakeup switch.
  * Exposes the BLE write timer handle.
  */
 #ifndef ENCODER_H
@@ -13,5 +13,9 @@ extern TimerHandle_t ble_write_timer;
 
 void encoder_init();
 
+// Arms (true) or disarms (false) the encoder pins as light-sleep wakeup sources.
+// Armed while the ambient screen allows light sleep, at the level opposite to the pins' current one.
+void encoder_set_sleep_wakeup(bool enable);
+
 #endif // ENCODER_H
 
@@ -318,6 +318,16 @@ static esp_err_t panel_sh8601_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool
     return ESP_OK;
 }
 
+esp_err_t esp_lcd_sh8601_set_idle_mode(esp_lcd_panel_handle_t panel, bool idle)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    esp_lcd_panel_io_handle_t io = sh8601->io;
+    int command = idle ? LCD_CMD_IDMON : LCD_CMD_IDMOFF;
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
+
 static esp_err_t panel_sh8601_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
 {
     ESP_LOGE(TAG, "swap_xy is not supported by this panel");
@@ -339,10 +349,18 @@ static esp_err_t panel_sh8601_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     int command = 0;
 
     if (on_off) {
+        // Leave sleep mode first; the panel needs time to restart its charge pumps
+        ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_SLPOUT, NULL, 0), TAG, "send command failed");
+        vTaskDelay(pdMS_TO_TICKS(120));
         command = LCD_CMD_DISPON;
     } else {
         command = LCD_CMD_DISPOFF;
     }
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
+    if (!on_off) {
+        // Stop panel scanning entirely, not just blank the output
+        ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_SLPIN, NULL, 0), TAG, "send command failed");
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
     return ESP_OK;
 }
@@ -55,6 +55,20 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Enter or leave the SH8601 idle mode (IDMON/IDMOFF)
+ *
+ * @note  In idle mode the panel shows only 8 colors (MSB of each channel) and runs at a reduced
+ *        refresh rate, which lowers panel power for static, mostly black content.
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ * @param[in] idle  True to enter idle mode, false to return to full color
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_set_idle_mode(esp_lcd_panel_handle_t panel, bool idle);
+
 /**
  * @brief LCD panel bus configuration structure
  *
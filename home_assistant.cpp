@@ -6,6 +6,12 @@
  * Corrected ambiguous setState call, HASelect options format,
  * and removed inaccessible variables from publish function.
  * Corrected HANumeric::toInt() to toInt8().
+ * Subscribes to shotstopper/shot/state and shotstopper/shot/weight for the live shot graph
+ * (published by shotstopper_automations.yaml; samples keep the sender's timestamp).
+ * Starts SNTP after WiFi connects so the ambient screen can show the time.
+ * Publishes battery level and voltage sensors.
+ * Publishes the estimated battery runtime; the MQTT keepalive follows the power profile
+ * (one planned reconnect per profile change, since it is only sent in CONNECT).
  */
 
 #include <WiFi.h>
@@ -23,11 +29,21 @@ const int mqtt_port = MQTT_PORT;
 const char* mqtt_user = MQTT_USER;
 const char* mqtt_password = MQTT_PASSWORD;
 
+// Wall clock for the ambient screen (POSIX TZ string, default Central European Time)
+#ifndef CLOCK_TIMEZONE
+#define CLOCK_TIMEZONE "CET-1CEST,M3.5.0,M10.5.0/3"
+#endif
+#define CLOCK_NTP_SERVER "pool.ntp.org"
+
 WiFiClient client;
 byte mac[6];
 HADevice device;
 HAMqtt mqtt(client, device);
 
+// Sender clock -> millis(), set by the first timestamped weight of each shot
+static uint32_t shot_clock_offset = 0;
+static bool shot_clock_synced = false;
+
 // Define HA entities
 HASwitch machinePower("linea_micra_power"); // Unique ID for the power switch
 HASelect preinfusionMode("linea_micra_mode"); // Unique ID for mode select
@@ -36,6 +52,9 @@ HANumber targetTemperature("linea_micra_target_temp", HANumber::PrecisionP1); //
 HANumber steamPower("linea_micra_steam_power", HANumber::PrecisionP0); // Unique ID, PrecisionP0 for integer
 HANumber preinfusionTime("linea_micra_preinfusion_time", HANumber::PrecisionP1); // Unique ID, PrecisionP1 for 0.1
 HANumber lastShotDuration("linea_micra_last_shot", HANumber::PrecisionP1); // Changed to HANumber to receive updates
+HASensorNumber batteryLevel("linea_micra_controller_battery", HASensorNumber::PrecisionP0);
+HASensorNumber batteryVoltage("linea_micra_controller_battery_voltage", HASensorNumber::PrecisionP2);
+HASensorNumber batteryRuntime("linea_micra_controller_battery_runtime", HASensorNumber::PrecisionP0);
 
 // Preinfusion mode options - Not used directly by setOptions anymore
 // const char* modes[] = {"Pre-brew", "Pre-infusion", "Disabled"};
@@ -106,6 +125,27 @@ void onLastShotUpdate(HANumeric number, HANumber* sender) {
     update_ha_last_shot_ui(duration);
 }
 
+// Weight payload: {"g": grams, "t": sender ms} or a bare number. The sender's
+// timestamp keeps the sample spacing when MQTT delivers a burst; it is mapped
+// onto millis() using the first sample of the shot. Without "t" the arrival
+// time is used.
+static void handle_shot_weight(const String& message) {
+    uint32_t now = millis();
+    int g_at = message.indexOf("\"g\":");
+    int t_at = message.indexOf("\"t\":");
+    float grams = g_at >= 0 ? strtof(message.c_str() + g_at + 4, NULL) : message.toFloat();
+    uint32_t t_ms = now;
+    if (t_at >= 0) {
+        uint32_t sender_ms = strtoul(message.c_str() + t_at + 4, NULL, 10);
+        if (!shot_clock_synced) {
+            shot_clock_offset = now - sender_ms;
+            shot_clock_synced = true;
+        }
+        t_ms = sender_ms + shot_clock_offset;
+    }
+    add_shot_sample(grams, t_ms);
+}
+
 void onMessage(const char* topic, const uint8_t* payload, uint16_t length) {
     Serial.printf("Received message on topic: %s\n", topic);
     char p[length + 1];
@@ -131,6 +171,15 @@ void onMessage(const char* topic, const uint8_t* payload, uint16_t length) {
         update_ha_preinfusion_time_ui(message.toFloat());
     } else if (strcmp(topic, "homeassistant/number/linea_micra_last_shot/state") == 0) {
         update_ha_last_shot_ui(message.toFloat());
+    } else if (strcmp(topic, "shotstopper/shot/weight") == 0) {
+        handle_shot_weight(message);
+    } else if (strcmp(topic, "shotstopper/shot/state") == 0) {
+        if (message == "start") {
+            shot_clock_synced = false;
+            start_shot_graph();
+        } else if (message == "stop") {
+            stop_shot_graph();
+        }
     }
 }
 
@@ -143,6 +192,9 @@ void onConnected() {
     mqtt.subscribe("homeassistant/number/linea_micra_steam_power/state");
     mqtt.subscribe("homeassistant/number/linea_micra_preinfusion_time/state");
     mqtt.subscribe("homeassistant/number/linea_micra_last_shot/state");
+    // Live shot data for the graph ("start"/"stop" and weight in grams at 10-20 Hz)
+    mqtt.subscribe("shotstopper/shot/state");
+    mqtt.subscribe("shotstopper/shot/weight");
 
     // Request initial states
     mqtt.publish("shotstopper/status", "online", false); // Announce presence and trigger automation
@@ -167,6 +219,7 @@ void ha_init() {
     Serial.println("\nWiFi connected.");
     Serial.print("IP address: ");
     Serial.println(WiFi.localIP());
+    configTzTime(CLOCK_TIMEZONE, CLOCK_NTP_SERVER); // Syncs in the background
 
     // Set device info (optional)
     device.setName("Linea Micra Controller");
@@ -195,8 +248,8 @@ void ha_init() {
     targetTemperature.setIcon("mdi:thermometer");
     targetTemperature.setUnitOfMeasurement("°C");
     targetTemperature.setMode(HANumber::ModeBox); // Or ModeSlider
-    targetTemperature.setMin(85.0);
-    targetTemperature.setMax(100.0);
+    targetTemperature.setMin(HA_TEMP_MIN);
+    targetTemperature.setMax(HA_TEMP_MAX);
     targetTemperature.setStep(0.1);
     targetTemperature.onCommand(onTargetTempCommand);
 
@@ -213,8 +266,8 @@ void ha_init() {
     preinfusionTime.setIcon("mdi:timer-sand");
     preinfusionTime.setUnitOfMeasurement("s");
     preinfusionTime.setMode(HANumber::ModeBox); // Or ModeSlider
-    preinfusionTime.setMin(0.0);
-    preinfusionTime.setMax(10.0); // Adjust max as needed
+    preinfusionTime.setMin(HA_PREINF_TIME_MIN);
+    preinfusionTime.setMax(HA_PREINF_TIME_MAX);
     preinfusionTime.setStep(0.1);
     preinfusionTime.onCommand(onPreinfusionTimeCommand);
 
@@ -226,6 +279,18 @@ void ha_init() {
     lastShotDuration.setStep(0.1);
     lastShotDuration.onCommand(onLastShotUpdate); // Use onCommand to receive updates
 
+    batteryLevel.setName("Controller Battery");
+    batteryLevel.setDeviceClass("battery");
+    batteryLevel.setUnitOfMeasurement("%");
+
+    batteryVoltage.setName("Controller Battery Voltage");
+    batteryVoltage.setDeviceClass("voltage");
+    batteryVoltage.setUnitOfMeasurement("V");
+
+    batteryRuntime.setName("Controller Battery Runtime");
+    batteryRuntime.setIcon("mdi:timer-sand");
+    batteryRuntime.setDeviceClass("duration");
+    batteryRuntime.setUnitOfMeasurement("min");
 
     Serial.printf("Attempting to connect to MQTT broker at %s:%d as user '%s'...\n", mqtt_server, mqtt_port, mqtt_user);
     mqtt.setDiscoveryPrefix("homeassistant"); // Explicitly set the discovery topic
@@ -273,4 +338,26 @@ void ha_trigger_backflush() {
     backflushSwitch.setState(true);
 }
 
+void ha_publish_battery(uint8_t percent, float volts) {
+    batteryLevel.setValue(percent);
+    batteryVoltage.setValue(volts);
+}
+
+void ha_publish_battery_runtime(uint16_t minutes) {
+    batteryRuntime.setValue(minutes);
+}
+
+void ha_set_mqtt_keepalive(uint16_t seconds) {
+    static uint16_t applied_s = 0;
+    if (seconds == applied_s) return;
+    applied_s = seconds;
+    mqtt.setKeepAlive(seconds);
+    // PubSubClient only sends the keepalive in CONNECT: drop the socket once so the
+    // next mqtt.loop() reconnects with it (a connection can otherwise last for days)
+    if (mqtt.isConnected()) {
+        Serial.printf("MQTT keepalive -> %u s, reconnecting to apply it\n", seconds);
+        client.stop();
+    }
+}
+
 
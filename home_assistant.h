@@ -13,6 +13,12 @@
 #include <ArduinoHA.h>
 #include <cstdint>
 
+// Ranges of the adjustable entities; the UI clamps knob input to the same limits
+#define HA_TEMP_MIN 85.0f
+#define HA_TEMP_MAX 100.0f
+#define HA_PREINF_TIME_MIN 0.0f
+#define HA_PREINF_TIME_MAX 10.0f
+
 // Function to initialize the Home Assistant connection
 void ha_init();
 
@@ -24,6 +30,13 @@ void ha_set_steam_power(int8_t power);
 void ha_set_preinfusion_time(float time);
 void ha_trigger_backflush();
 
+// --- Sensors published by the controller itself ---
+void ha_publish_battery(uint8_t percent, float volts);
+void ha_publish_battery_runtime(uint16_t minutes);
+
+// MQTT keepalive (the power profile stretches it); reconnects once if it changes while connected
+void ha_set_mqtt_keepalive(uint16_t seconds);
+
 // --- HA Device & Entity Declarations ---
 extern HADevice ha_device;
 extern HAMqtt mqtt;
@@ -35,6 +48,9 @@ extern HANumber targetTemperature;
 extern HANumber steamPower;
 extern HANumber preinfusionTime;
 extern HANumber lastShotDuration;
+extern HASensorNumber batteryLevel;
+extern HASensorNumber batteryVoltage;
+extern HASensorNumber batteryRuntime;
 
 #endif // HOME_ASSISTANT_H
 
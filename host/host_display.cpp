@@ -0,0 +1,175 @@
+/*
+ * Host display driver for the UI benchmarks (see host_display.h).
+ *
+ * lcd_lvgl_Init() keeps the same buffer geometry, render mode and even-pixel
+ * rounder as lcd_bsp.c so the flushed areas match what the panel sees.
+ */
+#include "host_display.h"
+#include "lcd_bsp.h"
+#include "lcd_config.h"
+#include "lcd_bl_pwm_bsp.h"
+#include "lvgl_display.h"
+#include "ui_profiler.h"
+#include <lvgl.h>
+#include <string.h>
+
+#define HOST_STEP_MS 5
+
+static lv_display_t* disp = NULL;
+static uint16_t framebuffer[EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES];
+static uint8_t draw_buf1[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * 2];
+static uint8_t draw_buf2[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * 2];
+
+static uint32_t virtual_tick_ms = 0;
+static bool display_asleep = false;
+static uint32_t flush_bytes_total = 0;
+static bool frame_flushed = false;
+static host_display_stats_t stats;
+
+static bool pointer_pressed = false;
+static int32_t pointer_x = 0;
+static int32_t pointer_y = 0;
+
+static uint32_t host_tick_get_cb(void) {
+    return virtual_tick_ms;
+}
+
+static void host_flush_cb(lv_display_t* display, const lv_area_t* area, uint8_t* px_map) {
+    if (display_asleep) {
+        lv_display_flush_ready(display);
+        return;
+    }
+    int64_t start_us = esp_timer_get_time();
+    int32_t w = lv_area_get_width(area);
+    const uint16_t* src = (const uint16_t*)px_map;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[y * EXAMPLE_LCD_H_RES + area->x1], src, w * sizeof(uint16_t));
+        src += w;
+    }
+    uint32_t bytes = (uint32_t)lv_area_get_size(area) * (LCD_BIT_PER_PIXEL / 8);
+    flush_bytes_total += bytes;
+    stats.bytes += bytes;
+    stats.areas++;
+    frame_flushed = true;
+    ui_profiler_record_flush(bytes, (uint32_t)(esp_timer_get_time() - start_us));
+    lv_display_flush_ready(display);
+}
+
+// Same rounding as lcd_bsp.c
+static void host_rounder_cb(lv_event_t* e) {
+    lv_area_t* area = (lv_area_t*)lv_event_get_param(e);
+    area->x1 = area->x1 & ~1;
+    area->y1 = area->y1 & ~1;
+    area->x2 = (area->x2 & ~1) + 1;
+    area->y2 = (area->y2 & ~1) + 1;
+    ui_profiler_record_area((uint32_t)lv_area_get_size(area));
+}
+
+static void host_refr_ready_cb(lv_event_t* e) {
+    (void)e;
+    if (frame_flushed) stats.frames++;
+    frame_flushed = false;
+}
+
+static void host_pointer_cb(lv_indev_t* indev, lv_indev_data_t* data) {
+    (void)indev;
+    data->point.x = pointer_x;
+    data->point.y = pointer_y;
+    data->state = pointer_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    if (pointer_pressed) reset_inactivity_timer();
+}
+
+void lcd_lvgl_Init(void) {
+    lv_init();
+    lv_tick_set_cb(host_tick_get_cb);
+
+    disp = lv_display_create(EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(disp, host_flush_cb);
+    lv_display_set_buffers(disp, draw_buf1, draw_buf2, sizeof(draw_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(disp, host_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, host_refr_ready_cb, LV_EVENT_REFR_READY, NULL);
+    ui_profiler_init(disp);
+
+    lv_indev_t* indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, host_pointer_cb);
+    lv_indev_set_display(indev, disp);
+
+    lvgl_display_init();
+}
+
+void lcd_display_set_sleep(bool sleep) {
+    if (sleep == display_asleep) return;
+    display_asleep = sleep;
+    lv_display_enable_invalidation(disp, !sleep);
+    if (!sleep) lv_obj_invalidate(lv_display_get_screen_active(disp));
+}
+
+bool lcd_display_is_asleep(void) {
+    return display_asleep;
+}
+
+void lcd_display_set_idle(bool idle) {
+    (void)idle;
+}
+
+void lcd_lvgl_set_low_power(bool enable) {
+    (void)enable;
+}
+
+// Single-threaded: the benchmark loop is the LVGL task, so there is nothing to wake
+void lcd_lvgl_wake(void) {}
+void lcd_lvgl_wake_from_isr(void) {}
+
+float lcd_lvgl_get_wakeups_per_sec(void) {
+    return 1000.0f / HOST_STEP_MS;
+}
+
+uint32_t lcd_lvgl_get_wakeups_total(void) {
+    return 0;
+}
+
+uint32_t lcd_lvgl_get_flush_bytes(void) {
+    return flush_bytes_total;
+}
+
+void setUpdutySubdivide(uint16_t duty) {
+    (void)duty;
+}
+
+void lcd_bl_pwm_bsp_init(uint16_t duty) {
+    (void)duty;
+}
+
+void host_display_set_pointer(bool pressed, int32_t x, int32_t y) {
+    pointer_pressed = pressed;
+    pointer_x = x;
+    pointer_y = y;
+}
+
+void host_display_run(uint32_t ms) {
+    for (uint32_t elapsed = 0; elapsed < ms; elapsed += HOST_STEP_MS) {
+        virtual_tick_ms += HOST_STEP_MS;
+        // Same loop body as example_lvgl_port_task()
+        lvgl_display_process_updates();
+        ui_profiler_poll();
+        int64_t start_us = esp_timer_get_time();
+        lv_timer_handler();
+        uint32_t handler_us = (uint32_t)(esp_timer_get_time() - start_us);
+        ui_profiler_record_handler(handler_us);
+        stats.render_us += handler_us;
+    }
+}
+
+void host_display_get_stats(host_display_stats_t* out) {
+    *out = stats;
+}
+
+void host_display_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+const uint16_t* host_display_framebuffer(void) {
+    return framebuffer;
+}
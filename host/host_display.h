@@ -0,0 +1,35 @@
+/*
+ * Host display driver for the UI benchmarks.
+ *
+ * Stands in for lcd_bsp.c: a 360x360 RGB565 display that flushes into a
+ * memory framebuffer, a pointer input device driven by the benchmark
+ * script and a virtual LVGL tick so timers and animations advance
+ * deterministically.
+ */
+#ifndef HOST_DISPLAY_H
+#define HOST_DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t frames;        // Refresh cycles that produced at least one flush
+    uint32_t areas;         // Flushed areas
+    uint64_t bytes;         // Bytes that would have been clocked into the panel
+    uint64_t render_us;     // Wall time spent in lv_timer_handler()
+} host_display_stats_t;
+
+// Pointer state returned by the next indev read
+void host_display_set_pointer(bool pressed, int32_t x, int32_t y);
+
+// Advances the virtual tick by ms, running the LVGL task loop body every 5 ms
+void host_display_run(uint32_t ms);
+
+// Counters since the last reset
+void host_display_get_stats(host_display_stats_t* stats);
+void host_display_reset_stats(void);
+
+// The framebuffer (EXAMPLE_LCD_H_RES x EXAMPLE_LCD_V_RES RGB565 pixels)
+const uint16_t* host_display_framebuffer(void);
+
+#endif // HOST_DISPLAY_H
@@ -0,0 +1,98 @@
+/*
+ * Host replacements for the firmware modules the UI links against:
+ * BLE client globals, encoder timer, Home Assistant setters, NVS, the battery
+ * monitor and the power profile (always the normal one).
+ * The HA setters log and record (host_stubs.h) what the UI requested, so the
+ * benchmark can check it.
+ */
+#include <Arduino.h>
+#include <Preferences.h>
+#include "ble_client.h"
+#include "encoder.h"
+#include "home_assistant.h"
+#include "battery_monitor.h"
+#include "power_profile.h"
+#include "touch_calib.h"
+#include "host_stubs.h"
+
+HostSerial Serial;
+Preferences preferences;
+
+int8_t target_weight = 36;
+QueueHandle_t bleCommandQueue = NULL;
+
+// Any non-NULL handle; resets are only counted
+static int ble_write_timer_storage;
+TimerHandle_t ble_write_timer = &ble_write_timer_storage;
+uint32_t host_ble_write_timer_resets = 0;
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait) {
+    (void)timer;
+    (void)ticks_to_wait;
+    host_ble_write_timer_resets++;
+    return pdPASS;
+}
+
+void encoder_set_sleep_wakeup(bool enable) { (void)enable; }
+
+bool battery_monitor_get(battery_state_t* out) {
+    *out = battery_state_t{};
+    out->measured_mv = 3880;
+    out->rest_mv = 3900;
+    out->load_ma = 200;
+    out->percent = 70;
+    out->calibrated = true;
+    out->readings = 1;
+    return true;
+}
+
+void battery_monitor_set_period_ms(uint32_t period_ms) { (void)period_ms; }
+
+static const power_profile_t host_power_profile = {"normal", 30000, 30000, 255, 0, 15};
+const power_profile_t* power_profile_current() { return &host_power_profile; }
+void power_profile_set_screen(power_screen_t screen) { (void)screen; }
+
+void ble_client_task_init() {}
+void send_ble_command(BLECommand command) { (void)command; }
+
+host_ha_requests_t host_ha = {};
+
+void ha_init() {}
+
+void ha_set_machine_power(bool state) {
+    Serial.printf("[ha] machine power -> %d\n", state);
+    host_ha.power = state;
+    host_ha.requests++;
+}
+
+void ha_set_preinfusion_mode(int8_t mode_index) {
+    Serial.printf("[ha] preinfusion mode -> %d\n", mode_index);
+    host_ha.mode_index = mode_index;
+    host_ha.requests++;
+}
+
+void ha_set_target_temperature(float temp) {
+    Serial.printf("[ha] target temperature -> %.1f\n", temp);
+    host_ha.temperature = temp;
+    host_ha.requests++;
+}
+
+void ha_set_steam_power(int8_t power) {
+    Serial.printf("[ha] steam power -> %d\n", power);
+    host_ha.steam_power = power;
+    host_ha.requests++;
+}
+
+void ha_set_preinfusion_time(float time) {
+    Serial.printf("[ha] preinfusion time -> %.1f\n", time);
+    host_ha.preinfusion_time = time;
+    host_ha.requests++;
+}
+
+void ha_trigger_backflush() {
+    Serial.println("[ha] backflush");
+    host_ha.requests++;
+}
+
+// touch_calib.cpp is device-only; the bench never calibrates
+bool touch_calib_active(void) { return false; }
@@ -0,0 +1,23 @@
+/*
+ * What the host stubs (host_stubs.cpp) recorded, for the benchmark's checks.
+ */
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Last value and total count of the Home Assistant requests the UI made
+typedef struct {
+    uint32_t requests;      // Every ha_set_*/ha_trigger_* call
+    bool power;
+    int8_t mode_index;
+    float temperature;
+    int8_t steam_power;
+    float preinfusion_time;
+} host_ha_requests_t;
+
+extern host_ha_requests_t host_ha;
+extern uint32_t host_ble_write_timer_resets;
+
+#endif // HOST_STUBS_H
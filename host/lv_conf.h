@@ -0,0 +1,32 @@
+/*
+ * LVGL configuration for the host UI build.
+ *
+ * Mirrors what the UI needs on the knob (RGB565, Montserrat 16/24/48,
+ * snapshots for ui_transition) without any OS or GPU integration.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE (256 * 1024U)
+
+#define LV_DEF_REFR_PERIOD 33
+#define LV_USE_OS LV_OS_NONE
+
+#define LV_USE_LOG 0
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+
+#define LV_USE_SNAPSHOT 1
+#define LV_USE_FLEX 1
+
+#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_MONTSERRAT_24 1
+#define LV_FONT_MONTSERRAT_48 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_16
+
+#endif // LV_CONF_H
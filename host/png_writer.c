@@ -0,0 +1,121 @@
+/*
+ * Minimal PNG writer (see png_writer.h).
+ *
+ * Image data goes into stored (uncompressed) deflate blocks, so no zlib is
+ * needed; the files are larger but byte-for-byte reproducible.
+ */
+#include "png_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t crc_table[256];
+
+static void crc_init(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_table[n] = c;
+    }
+}
+
+static uint32_t crc_update(uint32_t crc, const uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) crc = crc_table[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static bool write_chunk(FILE* f, const char* type, const uint8_t* data, uint32_t len) {
+    uint8_t header[8];
+    put_be32(header, len);
+    memcpy(header + 4, type, 4);
+    uint32_t crc = crc_update(0xffffffffu, header + 4, 4);
+    crc = crc_update(crc, data, len);
+    uint8_t trailer[4];
+    put_be32(trailer, crc ^ 0xffffffffu);
+    return fwrite(header, 1, 8, f) == 8 &&
+           (len == 0 || fwrite(data, 1, len, f) == len) &&
+           fwrite(trailer, 1, 4, f) == 4;
+}
+
+bool png_write_rgb565(const char* path, const uint16_t* pixels, uint32_t width, uint32_t height) {
+    static bool crc_ready = false;
+    if (!crc_ready) {
+        crc_init();
+        crc_ready = true;
+    }
+
+    // Raw scanlines: filter byte 0 followed by RGB888
+    const uint32_t stride = 1 + width * 3;
+    const uint32_t raw_len = stride * height;
+    uint8_t* raw = (uint8_t*)malloc(raw_len);
+    if (!raw) return false;
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = raw + y * stride;
+        *row++ = 0;
+        for (uint32_t x = 0; x < width; x++) {
+            uint16_t c = pixels[y * width + x];
+            uint8_t r = (c >> 11) & 0x1f, g = (c >> 5) & 0x3f, b = c & 0x1f;
+            *row++ = (uint8_t)((r << 3) | (r >> 2));
+            *row++ = (uint8_t)((g << 2) | (g >> 4));
+            *row++ = (uint8_t)((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib stream of stored blocks (max 65535 bytes each) plus Adler-32
+    const uint32_t blocks = (raw_len + 65534) / 65535;
+    const uint32_t z_len = 2 + blocks * 5 + raw_len + 4;
+    uint8_t* z = (uint8_t*)malloc(z_len);
+    if (!z) {
+        free(raw);
+        return false;
+    }
+    uint8_t* p = z;
+    *p++ = 0x78;
+    *p++ = 0x01;
+    uint32_t a = 1, b = 0;
+    for (uint32_t off = 0; off < raw_len; off += 65535) {
+        uint32_t n = raw_len - off < 65535 ? raw_len - off : 65535;
+        *p++ = (off + n == raw_len) ? 1 : 0;
+        *p++ = (uint8_t)n;
+        *p++ = (uint8_t)(n >> 8);
+        *p++ = (uint8_t)~n;
+        *p++ = (uint8_t)(~n >> 8);
+        memcpy(p, raw + off, n);
+        p += n;
+        for (uint32_t i = 0; i < n; i++) {
+            a = (a + raw[off + i]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    put_be32(p, (b << 16) | a);
+    free(raw);
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, width);
+    put_be32(ihdr + 4, height);
+    ihdr[8] = 8;   // bit depth
+    ihdr[9] = 2;   // truecolour
+    ihdr[10] = 0;  // deflate
+    ihdr[11] = 0;  // adaptive filtering
+    ihdr[12] = 0;  // no interlace
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    FILE* f = fopen(path, "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        ok = fwrite(signature, 1, sizeof(signature), f) == sizeof(signature) &&
+             write_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+             write_chunk(f, "IDAT", z, z_len) &&
+             write_chunk(f, "IEND", NULL, 0);
+        ok = (fclose(f) == 0) && ok;
+    }
+    free(z);
+    return ok;
+}
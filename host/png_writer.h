@@ -0,0 +1,21 @@
+/*
+ * Minimal PNG writer for golden-image dumps (uncompressed deflate blocks).
+ */
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Writes an RGB565 image as an 8-bit RGB PNG. Returns false on I/O error.
+bool png_write_rgb565(const char* path, const uint16_t* pixels, uint32_t width, uint32_t height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PNG_WRITER_H
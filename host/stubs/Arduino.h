@@ -0,0 +1,39 @@
+/*
+ * Host stand-in for the Arduino core: just what the UI code uses.
+ * Serial writes to stdout; timing comes from the monotonic clock.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "esp_timer.h"
+
+class HostSerial {
+public:
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+    void print(const char* text) { fputs(text, stdout); }
+    void println(const char* text) { puts(text); }
+    void println() { putchar('\n'); }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern HostSerial Serial;
+
+static inline unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+static inline void delay(uint32_t ms) { (void)ms; }
+
+#endif // HOST_ARDUINO_H
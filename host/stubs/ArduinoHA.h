@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the ArduinoHA library. The UI only needs the types to
+ * exist for the extern declarations in home_assistant.h.
+ */
+#ifndef HOST_ARDUINO_HA_H
+#define HOST_ARDUINO_HA_H
+
+class HADevice;
+class HAMqtt;
+class HASwitch;
+class HASelect;
+class HANumber;
+class HASensorNumber;
+
+#endif // HOST_ARDUINO_HA_H
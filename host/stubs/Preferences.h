@@ -0,0 +1,31 @@
+/*
+ * Host stand-in for the Arduino-ESP32 Preferences (NVS) class, kept in memory.
+ */
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <map>
+#include <string>
+#include <cstdint>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool read_only = false) { (void)name; (void)read_only; return true; }
+    void end() {}
+    bool isKey(const char* key) { return values.count(key) > 0; }
+    int8_t getChar(const char* key, int8_t default_value = 0) {
+        auto it = values.find(key);
+        return it == values.end() ? default_value : (int8_t)it->second;
+    }
+    size_t putChar(const char* key, int8_t value) { values[key] = value; return 1; }
+    int32_t getInt(const char* key, int32_t default_value = 0) {
+        auto it = values.find(key);
+        return it == values.end() ? default_value : it->second;
+    }
+    size_t putInt(const char* key, int32_t value) { values[key] = value; return 4; }
+
+private:
+    std::map<std::string, int32_t> values;
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,4 @@
+/* Host stand-in: included by lcd_bsp.h, nothing from it is used by the UI. */
+#ifndef HOST_DRIVER_SPI_MASTER_H
+#define HOST_DRIVER_SPI_MASTER_H
+#endif // HOST_DRIVER_SPI_MASTER_H
@@ -0,0 +1,24 @@
+/*
+ * Host stand-in for the ESP-IDF capability allocator. All memory is "PSRAM".
+ */
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+#include <stddef.h>
+
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_8BIT     (1 << 2)
+
+static inline void* heap_caps_malloc(size_t size, unsigned caps) { (void)caps; return malloc(size); }
+static inline void* heap_caps_calloc(size_t n, size_t size, unsigned caps) { (void)caps; return calloc(n, size); }
+static inline void* heap_caps_aligned_alloc(size_t alignment, size_t size, unsigned caps) {
+    (void)caps;
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+static inline void heap_caps_free(void* ptr) { free(ptr); }
+
+#endif // HOST_ESP_HEAP_CAPS_H
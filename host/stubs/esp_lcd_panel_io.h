@@ -0,0 +1,4 @@
+/* Host stand-in: included by lcd_bsp.h, nothing from it is used by the UI. */
+#ifndef HOST_ESP_LCD_PANEL_IO_H
+#define HOST_ESP_LCD_PANEL_IO_H
+#endif // HOST_ESP_LCD_PANEL_IO_H
@@ -0,0 +1,6 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for FreeRTOS software timers. The UI only resets the BLE
+ * write debounce timer; host_stubs.cpp counts the resets.
+ */
+#ifndef HOST_FREERTOS_TIMERS_H
+#define HOST_FREERTOS_TIMERS_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TimerHandle_t;
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait);
+
+#endif // HOST_FREERTOS_TIMERS_H
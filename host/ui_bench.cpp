@@ -0,0 +1,277 @@
+/*
+ * Scripted UI benchmark for the host build.
+ *
+ * Replays a fixed sequence of interactions (knob ticks, swipes, HA and
+ * battery updates) against the real UI code and reports, per step, the
+ * frames rendered, render time and the bytes/areas that would be flushed
+ * to the panel. With --png DIR the framebuffer is written after each step
+ * so renders can be diffed against golden images. --theme standard|lite
+ * picks the UI theme (default: UI_THEME_DEFAULT). The last steps idle into
+ * the ambient clock and show what its once-a-minute refresh costs.
+ * Weight changes and HA requests only come from knob_* steps, which feed
+ * detents through the mailbox knob ring into the LVGL encoder device, the
+ * same path the firmware's knob callbacks use; the resulting Home Assistant
+ * requests show up as [ha] lines and are checked against the expected values. Any failed check makes the run exit non-zero.
+ */
+#include "host_display.h"
+#include "host_stubs.h"
+#include "png_writer.h"
+#include "lcd_bsp.h"
+#include "lcd_config.h"
+#include "lvgl_display.h"
+#include "ui_profiler.h"
+#include "ble_client.h"
+#include "ui_theme.h"
+#include "ui_mailbox.h"
+#include "power_profile.h"
+#include "home_assistant.h"
+#include <Preferences.h>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+extern Preferences preferences;
+
+// Weight range enforced by the Shot Stopper screen (lvgl_display.cpp)
+#define BENCH_WEIGHT_MIN 0
+#define BENCH_WEIGHT_MAX 100
+
+static const char* png_dir = NULL;
+static int step_index = 0;
+static int failures = 0;
+
+// Records a failed expectation; main() exits non-zero if there was any
+static void check(bool ok, const char* fmt, ...) {
+    if (ok) return;
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "CHECK FAILED: ");
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    failures++;
+}
+
+static void end_step(const char* name) {
+    host_display_stats_t s;
+    host_display_get_stats(&s);
+    printf("%-24s %6lu %10.2f %10llu %6lu %10llu\n", name, (unsigned long)s.frames,
+           s.render_us / 1000.0, (unsigned long long)s.bytes, (unsigned long)s.areas,
+           (unsigned long long)(s.frames ? s.bytes / s.frames : 0));
+    if (png_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%02d_%s.png", png_dir, step_index, name);
+        if (!png_write_rgb565(path, host_display_framebuffer(), EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES)) {
+            fprintf(stderr, "Failed to write %s\n", path);
+        }
+    }
+    step_index++;
+    host_display_reset_stats();
+}
+
+// True if a label on the active screen contains text
+static bool screen_shows(lv_obj_t* obj, const char* text) {
+    if (lv_obj_check_type(obj, &lv_label_class) && strstr(lv_label_get_text(obj), text)) return true;
+    for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+        if (screen_shows(lv_obj_get_child(obj, (int32_t)i), text)) return true;
+    }
+    return false;
+}
+
+// A vertical swipe, delivered like the firmware's touch driver does (LVGL only sees taps)
+static void swipe(int32_t from_y, int32_t to_y) {
+    lvgl_display_handle_gesture(to_y < from_y ? UI_GESTURE_SWIPE_UP : UI_GESTURE_SWIPE_DOWN,
+                                EXAMPLE_LCD_H_RES / 2, to_y);
+    host_display_run(500); // Transition plus settle
+}
+
+// Taps the pointer at (x, y)
+static void tap(int32_t x, int32_t y) {
+    host_display_set_pointer(true, x, y);
+    host_display_run(50);
+    host_display_set_pointer(false, x, y);
+    host_display_run(50);
+}
+
+// Taps an HA control by its offset from the centre (same layout as create_ha_screen)
+static void tap_ha_control(float dx, float dy) {
+    const float radius = 130;
+    tap(EXAMPLE_LCD_H_RES / 2 + (int32_t)(radius * dx), EXAMPLE_LCD_V_RES / 2 + (int32_t)(radius * dy));
+}
+
+// Queues count detents gap_ms apart, as the knob callbacks would, running the UI in between.
+// Timestamps are synthetic so the acceleration curve is the same on every run.
+static void knob(int8_t delta, int count, uint32_t gap_ms) {
+    static uint32_t t_ms = 0;
+    for (int i = 0; i < count; i++) {
+        t_ms += gap_ms;
+        ui_mailbox_push_knob(delta, t_ms);
+        host_display_run(gap_ms);
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--png") == 0 && i + 1 < argc) {
+            png_dir = argv[++i];
+        } else if (strcmp(argv[i], "--theme") == 0 && i + 1 < argc) {
+            i++;
+            preferences.putChar(UI_THEME_NVS_KEY, strcmp(argv[i], "lite") == 0 ? UI_THEME_LITE : UI_THEME_STANDARD);
+        } else {
+            fprintf(stderr, "Usage: %s [--png DIR] [--theme standard|lite]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    lcd_lvgl_Init();
+    host_display_run(500);
+    host_display_reset_stats();
+
+    printf("\n%-24s %6s %10s %10s %6s %10s\n", "step", "frames", "render ms", "bytes", "areas", "bytes/frm");
+
+    host_display_run(200);
+    end_step("idle");
+
+    int8_t weight_before = target_weight;
+    knob(1, 10, 150); // Slow: one gram per detent
+    check(target_weight == weight_before + 10, "10 slow detents: weight %d, expected %d", target_weight,
+          weight_before + 10);
+    end_step("knob_10_ticks");
+
+    show_verification_checkmark();
+    host_display_run(100);
+    hide_verification_checkmark();
+    host_display_run(100);
+    end_step("checkmark");
+
+    update_ble_status(BLE_STATUS_CONNECTED);
+    host_display_run(100);
+    end_step("ble_connected");
+
+    swipe(EXAMPLE_LCD_V_RES - 40, 40);
+    end_step("swipe_up");
+
+    update_ha_power_switch_ui(true);
+    update_ha_mode_ui(1);
+    update_ha_temperature_ui(93.5f);
+    update_ha_steam_power_ui(3);
+    update_ha_preinfusion_time_ui(4.0f);
+    update_ha_last_shot_ui(27.4f);
+    host_display_run(100);
+    end_step("ha_updates");
+
+    for (int i = 0; i < 5; i++) {
+        update_ha_temperature_ui(93.5f + 0.5f * (i + 1));
+        host_display_run(100);
+    }
+    end_step("ha_temp_5_ticks");
+
+    uint32_t ha_requests = host_ha.requests;
+    knob(1, 3, 200); // Nothing focused: no change
+    host_display_run(1100);
+    check(host_ha.requests == ha_requests, "knob with nothing focused sent %lu HA requests",
+          (unsigned long)(host_ha.requests - ha_requests));
+    end_step("knob_ha_unfocused");
+
+    // From 96.0 C: -0.1 C twice, then +0.1 C and 9 detents at full speed (1.0 C each),
+    // which runs into the HA maximum of 100.0 C
+    ha_requests = host_ha.requests;
+    tap_ha_control(-0.866f, -0.5f); // Temperature
+    knob(-1, 2, 200); // Slow: 0.1 C per detent
+    knob(1, 10, 20); // Fast spin: accelerated, clamped
+    host_display_run(1100); // Debounce fires once
+    check(host_ha.requests == ha_requests + 1, "temperature spin sent %lu HA requests, expected 1",
+          (unsigned long)(host_ha.requests - ha_requests));
+    check(fabsf(host_ha.temperature - HA_TEMP_MAX) < 0.05f, "temperature after spin %.2f, expected %.1f",
+          host_ha.temperature, HA_TEMP_MAX);
+    end_step("knob_ha_temp_spin");
+
+    ha_requests = host_ha.requests;
+    tap_ha_control(0.866f, -0.5f); // Mode: one step per 3 detents
+    knob(1, 3, 200);
+    host_display_run(1100);
+    check(host_ha.requests == ha_requests + 1 && host_ha.mode_index == 2,
+          "3 detents on mode: %lu requests, mode %d, expected 1 request to mode 2",
+          (unsigned long)(host_ha.requests - ha_requests), host_ha.mode_index);
+    end_step("knob_ha_mode");
+
+    host_display_run(5000); // Deselection timeout
+    ha_requests = host_ha.requests;
+    knob(1, 3, 200);
+    host_display_run(1100);
+    check(host_ha.requests == ha_requests, "knob after deselection sent %lu HA requests",
+          (unsigned long)(host_ha.requests - ha_requests));
+    end_step("knob_ha_deselected");
+
+    swipe(40, EXAMPLE_LCD_V_RES - 40);
+    end_step("swipe_down");
+
+    knob(1, 10, 20);
+    knob(-1, 3, 200);
+    host_display_run(100);
+    end_step("knob_weight_spin");
+
+    knob(1, 40, 20); // Far past the top of the range
+    host_display_run(100);
+    check(target_weight == BENCH_WEIGHT_MAX, "weight %d after spinning up, expected %d", target_weight,
+          BENCH_WEIGHT_MAX);
+    knob(-1, 40, 20);
+    host_display_run(100);
+    check(target_weight == BENCH_WEIGHT_MIN, "weight %d after spinning down, expected %d", target_weight,
+          BENCH_WEIGHT_MIN);
+    knob(1, 36, 150); // Back to the default for the following steps
+    host_display_run(100);
+    end_step("knob_weight_limits");
+
+    // 30 s shot at 20 Hz, forcing one time-scale compression
+    start_shot_graph();
+    for (int i = 0; i < 600; i++) {
+        float t = i / 20.0f;
+        add_shot_sample(t < 6 ? 0.0f : (t - 6) * 1.5f, millis());
+        host_display_run(50);
+    }
+    stop_shot_graph();
+    host_display_run(50);
+    end_step("shot_30s_20hz");
+
+    update_battery_status(80);
+    host_display_run(100);
+    update_battery_status(15);
+    host_display_run(100);
+    end_step("battery");
+
+    update_battery_runtime(200);
+    host_display_run(100);
+    check(screen_shows(lv_screen_active(), "15% 3h20m"), "battery label doesn't show 15%% 3h20m");
+    update_battery_runtime(45);
+    host_display_run(100);
+    check(screen_shows(lv_screen_active(), "15% 45m"), "battery label doesn't show 15%% 45m");
+    update_battery_runtime(POWER_RUNTIME_UNKNOWN);
+    host_display_run(100);
+    check(!screen_shows(lv_screen_active(), "15% 45m") && screen_shows(lv_screen_active(), "15%"),
+          "battery label should drop the runtime when it is unknown");
+    end_step("battery_runtime");
+
+    // Dim after 30 s, ambient clock after 60 s, then two minute refreshes
+    reset_inactivity_timer();
+    host_display_run(60000 + 100);
+    end_step("ambient_enter");
+    host_display_run(120000);
+    end_step("ambient_2min");
+    reset_inactivity_timer();
+    host_display_run(100);
+    end_step("ambient_exit");
+
+    printf("\n");
+    ui_profiler_request_dump();
+    ui_profiler_request_screen_stats();
+    host_display_run(5);
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * Velocity-based knob acceleration.
+ *
+ * The multiplier follows a quadratic ease-in between the profile's slow and
+ * fast detent intervals, so moderate turns stay close to one step and only a
+ * deliberate fast spin makes large jumps. A direction change or a pause
+ * longer than slow_ms drops straight back to single steps.
+ */
+#include "knob_accel.h"
+
+int32_t knob_accel_step(knob_accel_t* accel, int8_t direction, uint32_t now_ms) {
+    const knob_accel_profile_t* p = accel->profile;
+    uint32_t gap = now_ms - accel->last_ms;
+    bool continuing = accel->last_dir == direction && accel->last_ms != 0 && gap < p->slow_ms;
+    accel->last_ms = now_ms;
+    accel->last_dir = direction;
+
+    if (!continuing) {
+        accel->interval_ms = 0;
+        return direction;
+    }
+    // Smooth over ~2 detents so one quick pair of clicks doesn't jump
+    accel->interval_ms = accel->interval_ms ? (accel->interval_ms + gap) / 2 : gap;
+    if (p->max_steps <= 1 || accel->interval_ms >= p->slow_ms) return direction;
+    if (accel->interval_ms <= p->fast_ms) return direction * (int32_t)p->max_steps;
+
+    // 0 at slow_ms .. 1 at fast_ms, squared
+    uint32_t span = p->slow_ms - p->fast_ms;
+    uint32_t speed = p->slow_ms - accel->interval_ms;
+    uint32_t extra = (uint32_t)(p->max_steps - 1) * speed * speed;
+    int32_t steps = 1 + (int32_t)((extra + span * span / 2) / (span * span));
+    return direction * steps;
+}
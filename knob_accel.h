@@ -0,0 +1,39 @@
+/*
+ * Header for velocity-based knob acceleration.
+ *
+ * Turns one detent into N value steps depending on how fast the knob is
+ * spinning. The detent interval is smoothed over the last few detents; slow
+ * turns always give exactly one step, fast spins ramp up to the profile's
+ * maximum. Each control keeps its own state and profile.
+ */
+#ifndef KNOB_ACCEL_H
+#define KNOB_ACCEL_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint16_t slow_ms;  // Detent interval at or above which every detent is one step
+    uint16_t fast_ms;  // Detent interval at or below which max_steps applies
+    uint8_t max_steps; // Steps per detent at full speed (1 disables acceleration)
+} knob_accel_profile_t;
+
+// Per-control state, initialised statically as {&profile, 0, 0, 0}
+typedef struct {
+    const knob_accel_profile_t* profile;
+    uint32_t last_ms;     // Time of the previous detent
+    uint32_t interval_ms; // Smoothed detent interval (0 = no history)
+    int8_t last_dir;
+} knob_accel_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Signed number of value steps for one detent in `direction` (+1/-1) at `now_ms`
+int32_t knob_accel_step(knob_accel_t* accel, int8_t direction, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KNOB_ACCEL_H
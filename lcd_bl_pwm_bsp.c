@@ -5,6 +5,8 @@
 #include "driver/gpio.h"
 #include "lcd_config.h"
 
+static uint16_t current_duty = 0; // Last duty written, read by the battery load estimate
+
 // Initializes the LEDC peripheral as a PWM timer to control the backlight GPIO
 void lcd_bl_pwm_bsp_init(uint16_t duty)
 {
@@ -28,6 +30,7 @@ void lcd_bl_pwm_bsp_init(uint16_t duty)
       };
   ESP_ERROR_CHECK_WITHOUT_ABORT(ledc_timer_config(&timer_conf));
   ESP_ERROR_CHECK_WITHOUT_ABORT(ledc_channel_config(&ledc_conf));
+  current_duty = duty;
 }
 
 // Function to update the backlight brightness
@@ -35,9 +38,15 @@ static void setUpduty(uint16_t duty)
 {
   ESP_ERROR_CHECK_WITHOUT_ABORT(ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, duty));
   ESP_ERROR_CHECK_WITHOUT_ABORT(ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1));
+  current_duty = duty;
 }
 
 void setUpdutySubdivide(uint16_t duty)
 {
   setUpduty(duty);
 }
+
+uint16_t lcd_bl_get_duty(void)
+{
+  return current_duty;
+}
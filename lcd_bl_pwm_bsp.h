@@ -12,6 +12,7 @@ extern "C"
 
   void lcd_bl_pwm_bsp_init(uint16_t duty);
   void setUpdutySubdivide(uint16_t duty);
+  uint16_t lcd_bl_get_duty(void); // Last duty set (0-255)
 
 #ifdef __cplusplus
 }
@@ -8,20 +8,91 @@
  * Increased LVGL task stack size.
  * Color format line commented out as LV_COLOR_16_SWAP is used in lv_conf.h.
  * Calls reset_inactivity_timer() on touch.
+ * Added lcd_display_set_sleep() to put the panel to sleep and suspend rendering while the screen is off.
+ * lcd_display_set_sleep() from another task is deferred to the LVGL task.
+ * LVGL task is now event driven: it sleeps on a task notification until the next LVGL timer
+ * deadline or a wake request, and the tick is read on demand from esp_timer_get_time().
+ * Drains the UI mailbox once per cycle before running LVGL timers.
+ * Flush, rounder and lv_timer_handler() are instrumented for ui_profiler.
+ * Flushes are asynchronous: draw_bitmap only queues the transfer and LVGL is told it is
+ * done from the panel IO's on_color_trans_done, which also times the flush on the wire.
+ * Added lcd_display_set_idle() (SH8601 8-color idle mode) and lcd_lvgl_set_low_power()
+ * (automatic light sleep) for the ambient screen.
+ * QSPI pixel clock, queue depth and max transfer size come from lcd_config.h, and
+ * lcd_panel_benchmark_request() runs a panel throughput benchmark on the LVGL task.
+ * Touch is interrupt driven: the CST816 INT line wakes the LVGL task, which resumes the
+ * input read timer; the timer is paused again after the release is reported, so no I2C
+ * traffic happens between touches. With EXAMPLE_TOUCH_I2C_ASYNC the coordinate read is
+ * queued and its completion wakes the task, so the read callback never waits on the bus.
+ * With EXAMPLE_TOUCH_HW_GESTURES swipes/long press come from the CST816 gesture register and
+ * go straight to lvgl_display_handle_gesture(); input CPU time is logged per touch session.
+ * LVGL only sees taps: the pointer stays at the press point and gestures are taken once per
+ * touch, at the lift (hardware code, or the press-to-lift movement without the gesture engine).
+ * Touch points go through a single touch_transform() (orientation + optional NVS calibration)
+ * instead of being flipped in both cst816.cpp and here.
  */
 
 #include "lcd_bsp.h"
 #include "esp_lcd_sh8601.h"
 #include "lcd_config.h"
 #include "cst816.h"
+#include "touch_calib.h"
 #include "lvgl_display.h" // Include our custom display header
 #include "lcd_bl_pwm_bsp.h" // Include backlight functions
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "sdkconfig.h"
+#include "ui_profiler.h"
 
 static SemaphoreHandle_t lvgl_mux = NULL;
+static TaskHandle_t lvgl_task_handle = NULL;
 #define LCD_HOST SPI2_HOST
 
 static esp_lcd_panel_io_handle_t amoled_panel_io_handle = NULL;
+static esp_lcd_panel_handle_t amoled_panel_handle = NULL;
 static lv_display_t *disp = NULL; // Global display handle for v9
+static bool display_asleep = false; // True while the panel is in sleep mode and rendering is suspended
+static bool display_idle = false;   // True while the panel is in 8-color idle mode
+
+// LVGL task wakeup accounting (reported every EXAMPLE_LVGL_WAKEUP_STATS_PERIOD_MS)
+static uint32_t lvgl_wakeups_deadline = 0; // Woke because an LVGL timer was due
+static uint32_t lvgl_wakeups_notify = 0;   // Woke because of an input/update event
+static float lvgl_wakeups_per_sec = 0.0f;  // Rate over the last completed window
+static uint32_t lvgl_wakeups_total = 0;    // All wakeups since boot
+
+static uint32_t flush_bytes_total = 0; // Pixel bytes sent to the panel since boot
+static volatile bool panel_bench_requested = false;
+// Sleep/wake posted from another task, applied by the LVGL task (0 = none, 1 = sleep, 2 = wake)
+static volatile uint8_t display_sleep_request = 0;
+
+// Touch input (CST816 INT -> GPIO ISR -> LVGL task)
+static lv_indev_t *touch_indev = NULL;
+static volatile bool touch_irq_pending = false;
+static volatile int64_t touch_irq_us = 0;     // Time of the first IRQ of the current press, 0 = none
+static volatile uint32_t touch_irq_count = 0;
+static bool touch_pressed = false;
+static lv_point_t touch_last_point = {0, 0};   // Latest point of the current touch
+static lv_point_t touch_press_point = {0, 0};  // Where it started; the only point LVGL sees
+// Per touch session: CPU time spent in LVGL input processing (read + pointer/gesture handling)
+static bool touch_session_active = false;
+static int64_t touch_session_start_us = 0;
+static uint32_t touch_session_reads = 0;
+static uint32_t touch_session_cpu_us = 0;
+static const char *touch_session_gesture = NULL;
+static uint32_t touch_stats_reads_mark = 0;   // getTouchReadCount() at the start of the window
+static uint32_t touch_stats_irq_mark = 0;
+static bool touch_stats_active = false;       // A press happened in the current window
+static uint32_t touch_latency_sum_us = 0;
+static uint32_t touch_latency_max_us = 0;
+static uint32_t touch_latency_count = 0;
+static volatile uint32_t panel_bench_done = 0; // Color transactions completed during the benchmark
+
+// LVGL flush in flight (set by the flush callback, cleared by on_color_trans_done)
+static bool flush_in_flight = false;          // Atomic: shared with the ISR
+static int64_t flush_start_us = 0;
+static uint32_t flush_wire_us = 0;            // draw_bitmap to transfer done, written by the ISR
+static uint32_t flush_pending_bytes = 0;      // Flush not yet handed to ui_profiler, 0 = none
+static const char *TAG = "lcd_bsp";
 
 // Initialization command list (unchanged)
 static const sh8601_lcd_init_cmd_t lcd_init_cmds[] = {
@@ -215,9 +286,14 @@ static const sh8601_lcd_init_cmd_t lcd_init_cmds[] = {
 
 // LVGL v9 function signatures
 static void example_lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
+static bool lcd_color_trans_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+static void flush_record_done(void);
 static void example_lvgl_rounder_cb(lv_event_t * e);
 static void example_lvgl_touch_cb(lv_indev_t * indev, lv_indev_data_t * data);
-static void example_increase_lvgl_tick(void *arg);
+static void touch_irq_init(void);
+static void touch_read_timer_cb(lv_timer_t *timer);
+static uint32_t example_lvgl_tick_get_cb(void);
+static void example_lvgl_timer_resume_cb(void *data);
 static void example_lvgl_port_task(void *arg);
 static void example_lvgl_unlock(void);
 static bool example_lvgl_lock(int timeout_ms);
@@ -234,14 +310,18 @@ void lcd_lvgl_Init(void) {
                                                                  EXAMPLE_PIN_NUM_LCD_DATA1,
                                                                  EXAMPLE_PIN_NUM_LCD_DATA2,
                                                                  EXAMPLE_PIN_NUM_LCD_DATA3,
-                                                                 EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * LCD_BIT_PER_PIXEL / 8);
+                                                                 EXAMPLE_LCD_MAX_TRANSFER_SZ);
     ESP_ERROR_CHECK_WITHOUT_ABORT(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
     esp_lcd_panel_io_handle_t io_handle = NULL;
 
-    // In v9, the flush ready callback is not set in IO config but during display creation
-    const esp_lcd_panel_io_spi_config_t io_config = SH8601_PANEL_IO_QSPI_CONFIG(EXAMPLE_PIN_NUM_LCD_CS,
-                                                                                NULL, // Callback removed here
-                                                                                NULL); // Context removed here
+    // The transfer-done callback needs the display, so it is registered once that exists
+    esp_lcd_panel_io_spi_config_t io_config = SH8601_PANEL_IO_QSPI_CONFIG(EXAMPLE_PIN_NUM_LCD_CS,
+                                                                          NULL, // Callback removed here
+                                                                          NULL); // Context removed here
+    io_config.pclk_hz = EXAMPLE_LCD_PIXEL_CLOCK_HZ;
+    io_config.trans_queue_depth = EXAMPLE_LCD_TRANS_QUEUE_DEPTH;
+    ESP_LOGI(TAG, "QSPI panel: %d MHz, queue depth %d, max transfer %d bytes",
+             EXAMPLE_LCD_PIXEL_CLOCK_HZ / 1000000, EXAMPLE_LCD_TRANS_QUEUE_DEPTH, EXAMPLE_LCD_MAX_TRANSFER_SZ);
     sh8601_vendor_config_t vendor_config = {
         .init_cmds = lcd_init_cmds,
         .init_cmds_size = sizeof(lcd_init_cmds) / sizeof(lcd_init_cmds[0]),
@@ -261,11 +341,16 @@ void lcd_lvgl_Init(void) {
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_new_panel_sh8601(io_handle, &panel_config, &panel_handle));
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_reset(panel_handle));
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_init(panel_handle));
+    amoled_panel_handle = panel_handle;
 
     // Reverted: Remove mirroring for default orientation
     // esp_lcd_panel_mirror(panel_handle, true, true);
 
     lv_init();
+    // Tick is derived from esp_timer on demand, no periodic tick interrupt needed
+    lv_tick_set_cb(example_lvgl_tick_get_cb);
+    // Wake the LVGL task whenever a timer is created/resumed so its deadline is honoured
+    lv_timer_handler_set_resume_cb(example_lvgl_timer_resume_cb, NULL);
 
     // Allocate draw buffers
     // Use MALLOC_CAP_DMA for direct memory access by SPI driver
@@ -286,9 +371,12 @@ void lcd_lvgl_Init(void) {
     // Pass allocated buffers directly
     lv_display_set_buffers(disp, buf1, buf2, EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * sizeof(lv_color_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
     lv_display_set_user_data(disp, panel_handle); // Associate panel handle with display
+    const esp_lcd_panel_io_callbacks_t io_cbs = {.on_color_trans_done = lcd_color_trans_done_cb};
+    ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_io_register_event_callbacks(io_handle, &io_cbs, disp));
 
     // Add rounder callback using events in v9
     lv_display_add_event_cb(disp, example_lvgl_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    ui_profiler_init(disp);
 
 
     // Create and register the input device (touch)
@@ -297,22 +385,16 @@ void lcd_lvgl_Init(void) {
     lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev, example_lvgl_touch_cb);
     lv_indev_set_display(indev, disp);
+    touch_indev = indev;
+    lv_timer_set_cb(lv_indev_get_read_timer(indev), touch_read_timer_cb);
+    touch_irq_init();
 
 
-    // Tick timer setup (remains similar)
-    const esp_timer_create_args_t lvgl_tick_timer_args = {
-        .callback = &example_increase_lvgl_tick,
-        .name = "lvgl_tick"
-    };
-    esp_timer_handle_t lvgl_tick_timer = NULL;
-    ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
-
     // LVGL task and mutex setup
     lvgl_mux = xSemaphoreCreateMutex();
     assert(lvgl_mux);
     // Increased stack size for LVGL task
-    xTaskCreate(example_lvgl_port_task, "LVGL_UI_Task", (8 * 1024), NULL, EXAMPLE_LVGL_TASK_PRIORITY, NULL);
+    xTaskCreate(example_lvgl_port_task, "LVGL_UI_Task", (8 * 1024), NULL, EXAMPLE_LVGL_TASK_PRIORITY, &lvgl_task_handle);
 
     // Initialize custom UI
     if (example_lvgl_lock(-1)) {
@@ -330,42 +412,495 @@ static void example_lvgl_unlock(void) {
     xSemaphoreGive(lvgl_mux);
 }
 
+// --- Touch interrupt ---
+
+static void IRAM_ATTR touch_isr_handler(void *arg) {
+    touch_irq_count++;
+    if (touch_irq_us == 0) {
+        touch_irq_us = esp_timer_get_time();
+    }
+    touch_irq_pending = true;
+    lcd_lvgl_wake_from_isr();
+}
+
+#if EXAMPLE_TOUCH_I2C_ASYNC
+// Set while the read callback has nothing to report and waits for the read in flight
+static volatile bool touch_async_waiting = false;
+
+// Async read finished (I2C ISR context). Only a read the callback is waiting for makes the
+// read timer due now; a prefetched sample is collected at the next read period, so a held
+// finger gives one I2C read per period instead of back-to-back reads.
+static void IRAM_ATTR touch_async_ready_isr(void) {
+    if (!touch_async_waiting) return;
+    touch_irq_pending = true;
+    lcd_lvgl_wake_from_isr();
+}
+#endif
+
+// Arms the CST816 INT pin and parks the input read timer until the first touch.
+// Without an INT pin the indev keeps LVGL's periodic polling.
+static void touch_irq_init(void) {
+#if EXAMPLE_TOUCH_I2C_ASYNC
+    touchSetReadyCallback(touch_async_ready_isr);
+#endif
+#if EXAMPLE_PIN_NUM_TOUCH_INT >= 0
+    const gpio_config_t int_conf = {
+        .pin_bit_mask = 1ULL << EXAMPLE_PIN_NUM_TOUCH_INT,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    ESP_ERROR_CHECK_WITHOUT_ABORT(gpio_config(&int_conf));
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) { // INVALID_STATE: already installed
+        ESP_LOGW(TAG, "GPIO ISR service unavailable (%s), touch stays polled", esp_err_to_name(err));
+        return;
+    }
+    ESP_ERROR_CHECK_WITHOUT_ABORT(gpio_isr_handler_add(EXAMPLE_PIN_NUM_TOUCH_INT, touch_isr_handler, NULL));
+    lv_timer_pause(lv_indev_get_read_timer(touch_indev));
+    ESP_LOGI(TAG, "Touch interrupt on GPIO%d, input read timer idle until touched", EXAMPLE_PIN_NUM_TOUCH_INT);
+#else
+    ESP_LOGI(TAG, "No touch INT pin, polling every input read");
+#endif
+}
+
+// Called by the LVGL task (lock held): an IRQ resumes the read timer and makes it due now
+static void touch_irq_service(void) {
+    if (!touch_irq_pending || touch_indev == NULL) {
+        return;
+    }
+    touch_irq_pending = false;
+    lv_timer_t *read_timer = lv_indev_get_read_timer(touch_indev);
+    lv_timer_resume(read_timer);
+    lv_timer_ready(read_timer);
+}
+
+// Hands the gesture of a touch that just lifted to the navigation logic. Called only from
+// the read that reports the lift, so every touch gives at most one gesture; the driver
+// records the code per touch, so a stale register from the previous swipe isn't resent.
+static void touch_deliver_gesture(void) {
+    ui_gesture_t gesture;
+#if EXAMPLE_TOUCH_HW_GESTURES
+    int8_t dx = 0, dy = 0;
+    uint8_t code = getTouchGesture();
+    switch (code) {
+        case CST816_GESTURE_SWIPE_UP: dy = -1; break;
+        case CST816_GESTURE_SWIPE_DOWN: dy = 1; break;
+        case CST816_GESTURE_SWIPE_LEFT: dx = -1; break;
+        case CST816_GESTURE_SWIPE_RIGHT: dx = 1; break;
+        case CST816_GESTURE_LONG_PRESS: break;
+        default: return; // None/clicks: taps are handled by LVGL pointer processing
+    }
+    if (code == CST816_GESTURE_LONG_PRESS) {
+        gesture = UI_GESTURE_LONG_PRESS;
+    } else {
+        // Swipes are in controller space; turn them like the points
+        touch_transform_dir(&dx, &dy);
+        gesture = dy < 0 ? UI_GESTURE_SWIPE_UP : dy > 0 ? UI_GESTURE_SWIPE_DOWN :
+                  dx < 0 ? UI_GESTURE_SWIPE_LEFT : UI_GESTURE_SWIPE_RIGHT;
+    }
+    touch_session_gesture = "hw";
+#else
+    int32_t dx = touch_last_point.x - touch_press_point.x;
+    int32_t dy = touch_last_point.y - touch_press_point.y;
+    if (LV_ABS(dx) < EXAMPLE_TOUCH_SWIPE_MIN_PX && LV_ABS(dy) < EXAMPLE_TOUCH_SWIPE_MIN_PX) {
+        return; // A tap, possibly a slightly moving one
+    }
+    if (LV_ABS(dy) >= LV_ABS(dx)) {
+        gesture = dy < 0 ? UI_GESTURE_SWIPE_UP : UI_GESTURE_SWIPE_DOWN;
+    } else {
+        gesture = dx < 0 ? UI_GESTURE_SWIPE_LEFT : UI_GESTURE_SWIPE_RIGHT;
+    }
+    touch_session_gesture = "sw";
+#endif
+    // LVGL saw a press and a lift at one point: turn the lift into a press-lost, not a click
+    lv_indev_wait_release(touch_indev);
+    lvgl_display_handle_gesture(gesture, touch_last_point.x, touch_last_point.y);
+}
+
+// Wraps LVGL's indev read timer to time input processing per touch session, so the
+// hardware and software gesture paths can be compared (EXAMPLE_TOUCH_HW_GESTURES 1 vs 0).
+static void touch_read_timer_cb(lv_timer_t *timer) {
+    int64_t start_us = esp_timer_get_time();
+    lv_indev_read_timer_cb(timer);
+    int64_t end_us = esp_timer_get_time();
+
+    if (touch_pressed && !touch_session_active) {
+        touch_session_active = true;
+        touch_session_start_us = start_us;
+        touch_session_reads = 0;
+        touch_session_cpu_us = 0;
+        touch_session_gesture = NULL;
+    }
+    if (!touch_session_active) {
+        return;
+    }
+    touch_session_reads++;
+    touch_session_cpu_us += (uint32_t)(end_us - start_us);
+    if (!touch_pressed) {
+        ESP_LOGI(TAG, "Touch session: %lu ms, %lu reads, %lu us input CPU (%lu us/read), gesture: %s",
+                 (unsigned long)((end_us - touch_session_start_us) / 1000), (unsigned long)touch_session_reads,
+                 (unsigned long)touch_session_cpu_us, (unsigned long)(touch_session_cpu_us / touch_session_reads),
+                 touch_session_gesture ? touch_session_gesture : "none");
+        touch_session_active = false;
+    }
+}
+
+static void touch_stats_log(int64_t window_us) {
+    touch_i2c_stats_t i2c;
+    getTouchStats(&i2c);
+    uint32_t reads = i2c.reads;
+    uint32_t irqs = touch_irq_count;
+    float reads_per_sec = (float)(reads - touch_stats_reads_mark) * 1000000.0f / (float)window_us;
+    if (touch_latency_count > 0) {
+        ESP_LOGI(TAG, "Touch (%s): %.1f I2C reads/s, %lu IRQs, IRQ-to-press latency avg %lu us, max %lu us",
+                 touch_stats_active ? "active" : "idle", reads_per_sec, (unsigned long)(irqs - touch_stats_irq_mark),
+                 (unsigned long)(touch_latency_sum_us / touch_latency_count), (unsigned long)touch_latency_max_us);
+    } else {
+        ESP_LOGI(TAG, "Touch (%s): %.1f I2C reads/s, %lu IRQs",
+                 touch_stats_active ? "active" : "idle", reads_per_sec, (unsigned long)(irqs - touch_stats_irq_mark));
+    }
+    if (i2c.errors || i2c.retries) {
+        ESP_LOGW(TAG, "Touch I2C since boot: %lu errors, %lu retries, %lu timeouts",
+                 (unsigned long)i2c.errors, (unsigned long)i2c.retries, (unsigned long)i2c.timeouts);
+    }
+    touch_stats_reads_mark = reads;
+    touch_stats_irq_mark = irqs;
+    touch_stats_active = touch_pressed;
+    touch_latency_sum_us = 0;
+    touch_latency_max_us = 0;
+    touch_latency_count = 0;
+}
+
+// --- Panel throughput benchmark ---
+
+#define LCD_QSPI_CMD_NOP ((0x02 << 24) | (0x00 << 8)) // SH8601 QSPI write-command framing (see esp_lcd_sh8601.c)
+static int64_t panel_bench_deadline_us = 0; // Shared by all cases of one run
+
+// Sends `count` windows of w x h pixels from buf and waits until the last one is on the wire.
+// Returns the elapsed time in microseconds, or -1 if the run's time budget ran out.
+static int64_t panel_bench_case(const uint16_t *buf, int w, int h, int count) {
+    // Outside the timed region: let the idle task feed the watchdog, then wait for anything
+    // still queued (LVGL's last flush, the previous case). tx_param blocks until the color
+    // queue is empty, and a NOP has no effect on the panel.
+    vTaskDelay(1);
+    esp_lcd_panel_io_tx_param(amoled_panel_io_handle, LCD_QSPI_CMD_NOP, NULL, 0);
+    if (esp_timer_get_time() >= panel_bench_deadline_us) {
+        return -1;
+    }
+    panel_bench_done = 0;
+    int64_t start_us = esp_timer_get_time();
+    int issued = 0;
+    for (int i = 0; i < count; i++) {
+        // Walk the window down/right so consecutive transfers hit different GRAM areas
+        int x = (i * 2 * w) % (EXAMPLE_LCD_H_RES - w + 1) & ~1;
+        int y = (i * h) % (EXAMPLE_LCD_V_RES - h + 1) & ~1;
+        if (esp_lcd_panel_draw_bitmap(amoled_panel_handle, x, y, x + w, y + h, buf) == ESP_OK) {
+            issued++;
+        }
+    }
+    while (panel_bench_done < (uint32_t)issued) {
+        // Busy-wait: a 1 ms RTOS tick would dominate the small-area cases
+        if (esp_timer_get_time() >= panel_bench_deadline_us) {
+            return -1;
+        }
+    }
+    return esp_timer_get_time() - start_us;
+}
+
+// Measures full-screen fills (as a full LVGL redraw sends them: one band at a time),
+// band-sized transfers and small-area updates. Reports MB/s and the fixed cost per
+// transaction (window commands + SPI setup), estimated from the small-area case.
+// Must be called with the LVGL lock held; the screen is redrawn afterwards.
+static void panel_benchmark_run(void) {
+    if (amoled_panel_io_handle == NULL || amoled_panel_handle == NULL || display_asleep) {
+        ESP_LOGW(TAG, "Panel benchmark skipped (panel not ready or asleep)");
+        return;
+    }
+    const int band_h = EXAMPLE_LVGL_BUF_HEIGHT;
+    const size_t band_bytes = EXAMPLE_LCD_H_RES * band_h * LCD_BIT_PER_PIXEL / 8;
+    uint16_t *buf = (uint16_t *)heap_caps_malloc(band_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "Panel benchmark skipped (no %u bytes of DMA RAM)", (unsigned)band_bytes);
+        return;
+    }
+    for (size_t i = 0; i < band_bytes / 2; i++) {
+        buf[i] = (uint16_t)(i * 0x0841); // Gradient so stuck data lines are visible
+    }
+
+    const int n = EXAMPLE_LCD_BENCH_ITERATIONS;
+    const int bands_per_frame = (EXAMPLE_LCD_V_RES + band_h - 1) / band_h;
+    const size_t frame_bytes = (size_t)EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * LCD_BIT_PER_PIXEL / 8;
+
+    panel_bench_deadline_us = esp_timer_get_time() + EXAMPLE_LCD_BENCH_TIMEOUT_MS * 1000LL;
+    int64_t frames_us = 0;
+    for (int f = 0; f < 10 && frames_us >= 0; f++) {
+        int64_t frame_us = panel_bench_case(buf, EXAMPLE_LCD_H_RES, band_h, bands_per_frame);
+        frames_us = frame_us < 0 ? -1 : frames_us + frame_us;
+    }
+    int64_t band_us = frames_us < 0 ? -1 : panel_bench_case(buf, EXAMPLE_LCD_H_RES, band_h, n);
+    int64_t small_us = band_us < 0 ? -1 : panel_bench_case(buf, 16, 16, n);
+    int64_t tiny_us = small_us < 0 ? -1 : panel_bench_case(buf, 2, 2, n);
+    esp_lcd_panel_io_tx_param(amoled_panel_io_handle, LCD_QSPI_CMD_NOP, NULL, 0); // buf must be off the wire
+
+    heap_caps_free(buf);
+    if (tiny_us < 0) {
+        ESP_LOGW(TAG, "Panel benchmark aborted: transfers did not complete within %d ms", EXAMPLE_LCD_BENCH_TIMEOUT_MS);
+        lv_obj_invalidate(lv_display_get_screen_active(disp));
+        return;
+    }
+
+    // Bytes per microsecond == MB/s
+    float band_mbps = (float)band_bytes * n / (float)band_us;
+    float wire_mbps = EXAMPLE_LCD_PIXEL_CLOCK_HZ / 2.0f / 1000000.0f; // 4 bits per clock
+    float tiny_per_trans_us = (float)tiny_us / n;
+    ESP_LOGI(TAG, "Panel benchmark @ %d MHz, queue depth %d (wire limit %.1f MB/s):",
+             EXAMPLE_LCD_PIXEL_CLOCK_HZ / 1000000, EXAMPLE_LCD_TRANS_QUEUE_DEPTH, wire_mbps);
+    ESP_LOGI(TAG, "  full screen (%d bands): %.2f ms/frame, %.1f fps, %.2f MB/s",
+             bands_per_frame, frames_us / 10 / 1000.0f, 10 * 1000000.0f / frames_us, (float)frame_bytes * 10 / frames_us);
+    ESP_LOGI(TAG, "  band %dx%d (%u B): %.1f us each, %.2f MB/s",
+             EXAMPLE_LCD_H_RES, band_h, (unsigned)band_bytes, (float)band_us / n, band_mbps);
+    ESP_LOGI(TAG, "  16x16 (512 B): %.1f us each, %.3f MB/s", (float)small_us / n, 512.0f * n / small_us);
+    ESP_LOGI(TAG, "  2x2 (8 B): %.1f us each -> ~%.1f us fixed overhead per transaction",
+             tiny_per_trans_us, tiny_per_trans_us - 8.0f / band_mbps);
+
+    lv_obj_invalidate(lv_display_get_screen_active(disp)); // Paint over the test pattern
+}
+
+// Runs the panel benchmark on the LVGL task at its next cycle (safe from any task).
+void lcd_panel_benchmark_request(void) {
+    panel_bench_requested = true;
+    lcd_lvgl_wake();
+}
+
 // Dedicated task that handles LVGL.
+// Sleeps until the next LVGL timer is due (or forever if none is) unless woken early
+// by lcd_lvgl_wake(), e.g. for input or UI updates coming from other tasks.
 static void example_lvgl_port_task(void *arg) {
-    uint32_t task_delay_ms = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
+    uint32_t task_delay_ms = 0;
+    int64_t stats_window_start_us = esp_timer_get_time();
+    int64_t touch_stats_window_start_us = stats_window_start_us;
     while (1) {
         // Lock the mutex while calling lv_timer_handler()
         if (example_lvgl_lock(-1)) {
+            if (panel_bench_requested) {
+                panel_bench_requested = false;
+                panel_benchmark_run(); // Owns the bus while the lock is held
+            }
+            if (display_sleep_request) {
+                bool sleep = display_sleep_request == 1;
+                display_sleep_request = 0;
+                lcd_display_set_sleep(sleep);
+            }
+            touch_irq_service();
+            touch_calib_poll();
+            lvgl_display_process_updates(); // Apply coalesced cross-task UI updates
+            ui_profiler_poll();
+            int64_t handler_start_us = esp_timer_get_time();
             task_delay_ms = lv_timer_handler();
+            ui_profiler_record_handler((uint32_t)(esp_timer_get_time() - handler_start_us));
+            flush_record_done(); // The frame's last flush, if it is already off the wire
             example_lvgl_unlock();
         }
-        if (task_delay_ms > EXAMPLE_LVGL_TASK_MAX_DELAY_MS) {
-            task_delay_ms = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
-        } else if (task_delay_ms < EXAMPLE_LVGL_TASK_MIN_DELAY_MS) {
-            task_delay_ms = EXAMPLE_LVGL_TASK_MIN_DELAY_MS;
+
+        TickType_t wait_ticks;
+        if (task_delay_ms == LV_NO_TIMER_READY) {
+            wait_ticks = portMAX_DELAY;
+        } else {
+            wait_ticks = pdMS_TO_TICKS(task_delay_ms);
+            if (wait_ticks == 0 && task_delay_ms > 0) {
+                wait_ticks = 1; // Don't spin when the deadline is below one RTOS tick
+            }
+        }
+
+        if (ulTaskNotifyTake(pdTRUE, wait_ticks) > 0) {
+            lvgl_wakeups_notify++;
+        } else {
+            lvgl_wakeups_deadline++;
+        }
+        lvgl_wakeups_total++;
+
+        int64_t now_us = esp_timer_get_time();
+        int64_t window_us = now_us - stats_window_start_us;
+        if (window_us >= (int64_t)EXAMPLE_LVGL_WAKEUP_STATS_PERIOD_MS * 1000) {
+            uint32_t total = lvgl_wakeups_deadline + lvgl_wakeups_notify;
+            lvgl_wakeups_per_sec = (float)total * 1000000.0f / (float)window_us;
+            ESP_LOGI(TAG, "LVGL wakeups: %.1f/s (%lu deadline, %lu event)",
+                     lvgl_wakeups_per_sec, (unsigned long)lvgl_wakeups_deadline, (unsigned long)lvgl_wakeups_notify);
+            lvgl_wakeups_deadline = 0;
+            lvgl_wakeups_notify = 0;
+            stats_window_start_us = now_us;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
+        if (now_us - touch_stats_window_start_us >= (int64_t)EXAMPLE_TOUCH_STATS_PERIOD_MS * 1000) {
+            touch_stats_log(now_us - touch_stats_window_start_us);
+            touch_stats_window_start_us = now_us;
+        }
+    }
+}
+
+// Wakes the LVGL task so pending work is handled now rather than at the next deadline.
+void lcd_lvgl_wake(void) {
+    if (lvgl_task_handle) {
+        xTaskNotifyGive(lvgl_task_handle);
+    }
+}
+
+// ISR-safe variant of lcd_lvgl_wake().
+void IRAM_ATTR lcd_lvgl_wake_from_isr(void) {
+    if (lvgl_task_handle) {
+        BaseType_t higher_prio_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(lvgl_task_handle, &higher_prio_woken);
+        portYIELD_FROM_ISR(higher_prio_woken);
+    }
+}
+
+float lcd_lvgl_get_wakeups_per_sec(void) {
+    return lvgl_wakeups_per_sec;
+}
+
+uint32_t lcd_lvgl_get_wakeups_total(void) {
+    return lvgl_wakeups_total;
+}
+
+uint32_t lcd_lvgl_get_flush_bytes(void) {
+    return flush_bytes_total;
+}
+
+static uint32_t example_lvgl_tick_get_cb(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void example_lvgl_timer_resume_cb(void *data) {
+    lcd_lvgl_wake();
+}
+
+// Puts the panel into sleep (display off) and stops LVGL from invalidating/rendering,
+// or wakes it and queues one full-screen redraw. LVGL object state (labels, timers)
+// keeps updating while asleep, so the redraw on wake shows the latest values.
+// Runs on the LVGL task: the panel command and the invalidation must not race a
+// flush. Called from any other task, the request is posted and the LVGL task is woken.
+void lcd_display_set_sleep(bool sleep) {
+    if (lvgl_task_handle && xTaskGetCurrentTaskHandle() != lvgl_task_handle) {
+        display_sleep_request = sleep ? 1 : 2;
+        lcd_lvgl_wake();
+        return;
+    }
+    if (sleep == display_asleep || amoled_panel_handle == NULL || disp == NULL) {
+        return;
+    }
+
+    if (sleep) {
+        lv_display_enable_invalidation(disp, false);
+        ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(amoled_panel_handle, false));
+        display_asleep = true;
+        ESP_LOGI(TAG, "Panel asleep, rendering suspended");
+    } else {
+        ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(amoled_panel_handle, true));
+        display_asleep = false;
+        lv_display_enable_invalidation(disp, true);
+        // Everything that changed while asleep is covered by a single redraw
+        lv_obj_invalidate(lv_display_get_screen_active(disp));
+        ESP_LOGI(TAG, "Panel awake, full redraw queued");
     }
 }
 
-static void example_increase_lvgl_tick(void *arg) {
-    lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
+bool lcd_display_is_asleep(void) {
+    return display_asleep;
 }
 
+// Switches the panel between full color and its 8-color, reduced-refresh idle mode.
+// Content drawn while idle should stick to pure black/white/primaries, anything else
+// is quantised to the top bit of each channel.
+void lcd_display_set_idle(bool idle) {
+    if (idle == display_idle || amoled_panel_handle == NULL) {
+        return;
+    }
+    ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_sh8601_set_idle_mode(amoled_panel_handle, idle));
+    display_idle = idle;
+    ESP_LOGI(TAG, "Panel idle mode %s", idle ? "on (8 colors)" : "off");
+}
+
+// Lets the CPU drop to EXAMPLE_PM_MIN_FREQ_MHZ and enter automatic light sleep whenever
+// every task is blocked (the LVGL task sleeps until its next timer deadline), or
+// restores a fixed EXAMPLE_PM_MAX_FREQ_MHZ clock.
+// Needs CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE; without them this only logs.
+void lcd_lvgl_set_low_power(bool enable) {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = EXAMPLE_PM_MAX_FREQ_MHZ,
+        .min_freq_mhz = enable ? EXAMPLE_PM_MIN_FREQ_MHZ : EXAMPLE_PM_MAX_FREQ_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = enable,
+#endif
+    };
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+        return;
+    }
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    ESP_LOGI(TAG, "Low power %s (CPU %d-%d MHz, light sleep %s)", enable ? "on" : "off",
+             pm_config.min_freq_mhz, pm_config.max_freq_mhz, enable ? "on" : "off");
+#else
+    ESP_LOGI(TAG, "Low power %s (CPU %d-%d MHz, no tickless idle so no light sleep)", enable ? "on" : "off",
+             pm_config.min_freq_mhz, pm_config.max_freq_mhz);
+#endif
+#else
+    ESP_LOGI(TAG, "Low power %s requested, but CONFIG_PM_ENABLE is off", enable ? "on" : "off");
+#endif
+}
+
+
+// Panel IO transfer done (ISR context). Color transfers complete in order, so the first one
+// after an LVGL flush was queued is that flush; any other is a benchmark transfer.
+static bool lcd_color_trans_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx) {
+    if (__atomic_load_n(&flush_in_flight, __ATOMIC_ACQUIRE)) {
+        flush_wire_us = (uint32_t)(esp_timer_get_time() - flush_start_us);
+        __atomic_store_n(&flush_in_flight, false, __ATOMIC_RELEASE);
+        lv_display_flush_ready((lv_display_t *)user_ctx);
+    } else {
+        panel_bench_done++;
+    }
+    return false;
+}
+
+// Hands a completed flush to ui_profiler (LVGL task only; ui_profiler isn't ISR safe)
+static void flush_record_done(void) {
+    if (flush_pending_bytes == 0 || __atomic_load_n(&flush_in_flight, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    ui_profiler_record_flush(flush_pending_bytes, flush_wire_us);
+    flush_pending_bytes = 0;
+}
 
 // LVGL v9 flush callback signature
 static void example_lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map) {
     esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t)lv_display_get_user_data(display);
+    flush_record_done(); // LVGL waited for the previous flush before handing over this one
+    if (display_asleep) {
+        // Nothing is visible; don't clock pixels into a sleeping panel
+        lv_display_flush_ready(display);
+        return;
+    }
     int offsetx1 = area->x1;
     int offsetx2 = area->x2;
     int offsety1 = area->y1;
     int offsety2 = area->y2;
 
-    // Pass the draw buffer directly to the panel driver
-    esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map);
-
-    // Indicate flushing is ready (moved from separate callback)
-    lv_display_flush_ready(display);
+    uint32_t flush_bytes = (uint32_t)(offsetx2 - offsetx1 + 1) * (offsety2 - offsety1 + 1) * (LCD_BIT_PER_PIXEL / 8);
+    flush_bytes_total += flush_bytes;
+
+    // Pass the draw buffer directly to the panel driver; LVGL renders into the other
+    // buffer while it goes out, and is released by lcd_color_trans_done_cb()
+    flush_pending_bytes = flush_bytes;
+    flush_start_us = esp_timer_get_time();
+    __atomic_store_n(&flush_in_flight, true, __ATOMIC_RELEASE);
+    if (esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map) != ESP_OK) {
+        __atomic_store_n(&flush_in_flight, false, __ATOMIC_RELEASE);
+        flush_pending_bytes = 0;
+        lv_display_flush_ready(display); // Nothing was queued, so no completion will come
+    }
 }
 
 // LVGL v9 rounder callback signature (using event system)
@@ -378,30 +913,65 @@ static void example_lvgl_rounder_cb(lv_event_t * e) {
     area->y1 = area->y1 & ~1;
     area->x2 = (area->x2 & ~1) + 1; // Round down then add 1 to ensure width includes the last pixel
     area->y2 = (area->y2 & ~1) + 1; // Round down then add 1 to ensure height includes the last pixel
+
+    ui_profiler_record_area((uint32_t)lv_area_get_size(area));
 }
 
 
 // LVGL v9 touch input read callback signature
 static void example_lvgl_touch_cb(lv_indev_t * indev, lv_indev_data_t * data) {
     uint16_t tp_x = 0, tp_y = 0;
+#if EXAMPLE_TOUCH_I2C_ASYNC
+    int8_t result = touchGetAsyncResult(&tp_x, &tp_y);
+    if (result < 0) {
+        // Nothing new yet: make sure a read is in flight and repeat the last state.
+        // Its completion wakes this task and makes the read timer due again.
+        touch_async_waiting = true;
+        touchReadAsync();
+        data->point = touch_press_point;
+        data->state = touch_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        return;
+    }
+    touch_async_waiting = false;
+    bool touched = result > 0;
+    if (touched) {
+        touchReadAsync(); // Next sample transfers now and is collected at the next read period
+    }
+#else
     bool touched = getTouch(&tp_x, &tp_y); // Assuming getTouch returns bool/uint8_t
+#endif
 
     if (touched) {
-        // Re-apply coordinate transformation for persistent mirroring issue
-        data->point.x = EXAMPLE_LCD_H_RES - 1 - tp_x;
-        data->point.y = EXAMPLE_LCD_V_RES - 1 - tp_y;
+        if (!touch_pressed && touch_irq_us != 0) {
+            // Press becomes an LVGL event as soon as this read returns
+            uint32_t latency_us = (uint32_t)(esp_timer_get_time() - touch_irq_us);
+            touch_latency_sum_us += latency_us;
+            touch_latency_count++;
+            if (latency_us > touch_latency_max_us) touch_latency_max_us = latency_us;
+        }
+        // Orientation + calibration in one step, clamped to the panel
+        touch_transform(tp_x, tp_y, &touch_last_point.x, &touch_last_point.y);
+        if (!touch_pressed) touch_press_point = touch_last_point;
+        touch_pressed = true;
+        touch_stats_active = true;
+        // Motion is never passed on, so LVGL doesn't scroll or run its own gesture detection
+        data->point = touch_press_point;
         data->state = LV_INDEV_STATE_PRESSED;
-        // Verify coordinates are within bounds after transformation
-        if (data->point.x >= EXAMPLE_LCD_H_RES) data->point.x = EXAMPLE_LCD_H_RES - 1;
-        if (data->point.y >= EXAMPLE_LCD_V_RES) data->point.y = EXAMPLE_LCD_V_RES - 1;
-        if (data->point.x < 0) data->point.x = 0;
-        if (data->point.y < 0) data->point.y = 0;
 
         // Reset inactivity timer on touch press
         reset_inactivity_timer();
 
     } else {
+        if (touch_pressed) touch_deliver_gesture();
+        data->point = touch_press_point;
         data->state = LV_INDEV_STATE_RELEASED;
+        touch_pressed = false;
+        touch_irq_us = 0;
+#if EXAMPLE_PIN_NUM_TOUCH_INT >= 0
+        // The release is delivered by this read; sleep until the next IRQ.
+        // An IRQ that raced with this read is still pending and resumes the timer.
+        lv_timer_pause(lv_indev_get_read_timer(indev));
+#endif
     }
 }
 
@@ -20,15 +20,18 @@
 extern "C" {
 #endif
 
-// LVGL v9 prototypes
-static void example_lvgl_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
-static void example_lvgl_rounder_cb(lv_event_t * e); // Made static
-static void example_increase_lvgl_tick(void *arg);
-static void example_lvgl_port_task(void *arg);
-static void example_lvgl_unlock(void);
-static bool example_lvgl_lock(int timeout_ms);
+// LVGL v9 display driver (the static callbacks are declared in lcd_bsp.c)
 void lcd_lvgl_Init(void);
-static void example_lvgl_touch_cb(lv_indev_t * indev, lv_indev_data_t * data);
+void lcd_display_set_sleep(bool sleep); // Applied on the LVGL task (posted when called elsewhere)
+bool lcd_display_is_asleep(void);
+void lcd_display_set_idle(bool idle);
+void lcd_lvgl_set_low_power(bool enable);
+void lcd_lvgl_wake(void);
+void lcd_lvgl_wake_from_isr(void);
+float lcd_lvgl_get_wakeups_per_sec(void);
+uint32_t lcd_lvgl_get_wakeups_total(void);
+uint32_t lcd_lvgl_get_flush_bytes(void);
+void lcd_panel_benchmark_request(void);
 
 #ifdef __cplusplus
 }
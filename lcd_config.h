@@ -15,18 +15,49 @@
 #define EXAMPLE_PIN_NUM_LCD_RST     21
 #define EXAMPLE_PIN_NUM_BK_LIGHT    47
 
+// QSPI bus tuning; run the panel benchmark (Serial 'b') after changing these
+#ifndef EXAMPLE_LCD_PIXEL_CLOCK_HZ
+#define EXAMPLE_LCD_PIXEL_CLOCK_HZ     (40 * 1000 * 1000)         //QSPI clock; 4 data lines, so bytes/s = clock / 2
+#endif
+#ifndef EXAMPLE_LCD_TRANS_QUEUE_DEPTH
+#define EXAMPLE_LCD_TRANS_QUEUE_DEPTH  10                         //Color transactions the SPI driver may queue
+#endif
+#ifndef EXAMPLE_LCD_MAX_TRANSFER_SZ
+#define EXAMPLE_LCD_MAX_TRANSFER_SZ    (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * LCD_BIT_PER_PIXEL / 8) //Largest single DMA transfer
+#endif
+#define EXAMPLE_LCD_BENCH_ITERATIONS   50                         //Transfers per benchmark case
+#define EXAMPLE_LCD_BENCH_TIMEOUT_MS   5000                       //Budget for all benchmark cases together
+
 #define EXAMPLE_LVGL_BUF_HEIGHT        (EXAMPLE_LCD_V_RES / 10)
-#define EXAMPLE_LVGL_TICK_PERIOD_MS    2                          //Timer time
-#define EXAMPLE_LVGL_TASK_MAX_DELAY_MS 500                        //LVGL Indicates the maximum time for a task to run
-#define EXAMPLE_LVGL_TASK_MIN_DELAY_MS 1                          //LVGL Minimum time to run a task
+#define EXAMPLE_LVGL_WAKEUP_STATS_PERIOD_MS 10000                 //Window for the LVGL task wakeups/s metric
 #define EXAMPLE_LVGL_TASK_STACK_SIZE   (4 * 1024)                 //LVGL runs the task stack
 #define EXAMPLE_LVGL_TASK_PRIORITY     2                          //LVGL Running task priority
+#define EXAMPLE_PM_MAX_FREQ_MHZ        240                        //CPU clock while the UI is active
+#define EXAMPLE_PM_MIN_FREQ_MHZ        40                         //CPU clock floor in the ambient screen (light sleep when idle)
 
 #define EXAMPLE_TOUCH_ADDR                0x15
 #define EXAMPLE_PIN_NUM_TOUCH_SCL 12
 #define EXAMPLE_PIN_NUM_TOUCH_SDA 11
+#define EXAMPLE_TOUCH_I2C_HZ      400000  //Touch bus clock, CST816 supports up to 400 kHz
+#define EXAMPLE_TOUCH_I2C_ASYNC   0       //1 = queue coordinate reads, the LVGL task never waits on the bus
+#define EXAMPLE_TOUCH_I2C_RETRIES 2       //Extra attempts for a failed blocking read
+#define EXAMPLE_TOUCH_I2C_TIMEOUT_MS 10   //Per-attempt timeout
+#define EXAMPLE_TOUCH_HW_GESTURES 1       //1 = swipes/long press from the CST816 gesture register, 0 = swipes from the press-to-lift movement
+#define EXAMPLE_TOUCH_SWIPE_MIN_PX 60     //Movement that counts as a swipe without the gesture register
+#define EXAMPLE_PIN_NUM_TOUCH_INT 9       //CST816 INT (active low); -1 = poll I2C on every LVGL input read
+#define EXAMPLE_TOUCH_STATS_PERIOD_MS 10000 //Window for the touch I2C reads/s and latency log
 
 
 //#define Backlight_Testing
 //#define EXAMPLE_Rotate_90
+
+// Touch orientation relative to the panel, applied once in touch_transform() (touch_calib.h).
+// Rotation is clockwise in degrees (0/90/180/270); mirrors are applied after it.
+#ifdef EXAMPLE_Rotate_90
+#define EXAMPLE_TOUCH_ROTATION 90
+#else
+#define EXAMPLE_TOUCH_ROTATION 0
+#endif
+#define EXAMPLE_TOUCH_MIRROR_X 0
+#define EXAMPLE_TOUCH_MIRROR_Y 0
 #endif
\ No newline at end of file
@@ -6,6 +6,31 @@
  * Added inactivity timer for screen dimming and backlight off.
  * Implemented moving average filter for battery readings to stabilize percentage.
  * Preset buttons now use the debounce timer before triggering BLE write.
+ * Screen-off now puts the panel to sleep and suspends rendering until the next touch/encoder event.
+ * Public update_* functions now post to the UI mailbox; the LVGL task applies them in
+ * lvgl_display_process_updates(), so other tasks never touch LVGL objects directly.
+ * Value labels go through ui_binding, which skips redraws for unchanged values and
+ * formats numbers with an integer routine instead of printf.
+ * Weight is shown with ui_digit_readout, which only redraws the digits that changed.
+ * Swipes use ui_transition, which slides cached snapshots of the two screens.
+ * The HA screen is built on first navigation and optionally torn down after disuse.
+ * Added a live weight-vs-time shot graph fed through the mailbox sample ring.
+ * Added an edge arc gauge for the target weight built from precomputed segment masks.
+ * Fonts come from ui_fonts (stock Montserrat behind a decoded-glyph cache).
+ * Screen/button styling goes through ui_theme (standard or AMOLED "lite" outlines).
+ * Screen-off is replaced by an ambient clock screen (time, target weight, machine power)
+ * refreshed once a minute in the panel's idle mode, with burn-in shift and light sleep.
+ * Swipes/long press come from the touch driver (CST816 gesture register or its own
+ * press-to-lift detection) through lvgl_display_handle_gesture(); LVGL only sees taps.
+ * Temperature and pre-infusion time changes are accelerated by knob speed (knob_accel).
+ * The knob is an LVGL encoder input device (ui_encoder) with one group per screen: taps
+ * focus HA controls, detents arrive as LV_EVENT_KEY on the focused object, and
+ * deselecting focuses an idle object. Value updates still go through the mailbox, so a
+ * burst of detents renders once.
+ * Battery sampling moved to battery_monitor (DMA ADC task with a discharge table); the
+ * label is fed through the mailbox and the ambient screen only stretches its period.
+ * The battery label shows the estimated runtime. Inactivity timeouts and the brightness
+ * cap follow the power profile, and screen state changes are reported to it.
  */
 #include "lvgl_display.h"
 #include "ble_client.h"
@@ -13,46 +38,132 @@
 #include "app_events.h"
 #include "home_assistant.h"
 #include "lcd_bl_pwm_bsp.h" // Include backlight functions
+#include "lcd_bsp.h" // Panel sleep / render suspension
+#include "lcd_config.h" // Panel resolution
+#include "ui_mailbox.h" // Cross-task UI updates
+#include "ui_binding.h" // Change-detecting label updates
+#include "ui_digit_readout.h" // Per-digit weight readout
+#include "ui_transition.h" // Snapshot-cached screen swipes
+#include "ui_shot_graph.h" // Live shot graph
+#include "ui_arc_gauge.h" // Target weight ring
+#include "ui_fonts.h" // Font set + glyph cache
+#include "ui_theme.h" // Standard / lite theme
+#include "knob_accel.h" // Knob speed -> step size
+#include "ui_encoder.h" // Knob input device + groups
+#include "battery_monitor.h" // Battery level (sampled in its own task)
+#include "power_profile.h" // Low-battery timeouts/brightness, runtime estimate
+#include "touch_calib.h" // Gestures are ignored while calibrating
 #include <lvgl.h>
 #include <cstdio>
-#include <Arduino.h> // Required for analogReadMilliVolts, FreeRTOS timers
+#include <cstring>
+#include <Arduino.h> // Required for millis, FreeRTOS timers
 #include <Preferences.h> // Needed for preset saving/loading
+#include <time.h>
+#include <sys/time.h>
 
 // --- Brightness / Inactivity ---
 #define INACTIVITY_TIMEOUT_DIM_MS 30000 // 30 seconds to dim
 #define INACTIVITY_TIMEOUT_OFF_MS 30000 // Another 30 seconds (60 total) to off
 #define BRIGHTNESS_HIGH 178 // ~70% (255 * 0.7)
 #define BRIGHTNESS_DIM 51   // ~20% (255 * 0.2)
+#define BRIGHTNESS_AMBIENT 26 // ~10%, ambient clock
 #define BRIGHTNESS_OFF 0    // 0%
 
 static lv_timer_t* inactivity_timer = NULL;
-static uint8_t current_brightness_level = BRIGHTNESS_HIGH; // Track current level
+// Current power profile values (normal profile until the first update)
+static uint32_t inactivity_dim_ms = INACTIVITY_TIMEOUT_DIM_MS;
+static uint32_t inactivity_off_ms = INACTIVITY_TIMEOUT_OFF_MS;
+static uint8_t brightness_cap = 255;
+
+// --- HA Screen Lifetime ---
+#define HA_SCREEN_LAZY 1              // 1 = build the HA screen on first swipe, 0 = at boot
+#define HA_SCREEN_TEARDOWN_MS 300000  // Delete the HA screen after 5 min away from it, 0 = keep it
 
-// --- Battery Monitoring ---
-#define BATTERY_ADC_PIN 1   // GPIO1 for battery voltage divider
-#define BATTERY_MAX_MV 4200 // Max voltage (4.2V) in millivolts
-#define BATTERY_MIN_MV 3000 // Min voltage (3.0V) in millivolts (conservative)
-#define BATTERY_READING_COUNT 5 // Number of readings to average
+static lv_timer_t* ha_teardown_timer = NULL;
+static bool first_frame_logged = false;
+static uint8_t current_brightness_level = BRIGHTNESS_HIGH; // Track current level
 
-static uint32_t battery_readings[BATTERY_READING_COUNT];
-static int battery_reading_index = 0;
-static uint32_t battery_reading_sum = 0;
-static bool battery_filter_initialized = false;
+// --- Ambient Screen ---
+#define AMBIENT_SCREEN_ENABLED 1   // 1 = ambient clock after the dim stage, 0 = panel off
+#define AMBIENT_REFRESH_MS 60000   // Fallback refresh period until the clock is synced
+#define AMBIENT_SHIFT_PX 6         // Burn-in shift radius around the centre
+#define AMBIENT_BATTERY_PERIOD_MS 60000 // Battery sampling period while ambient
+#define AMBIENT_MEASURE_EMISSION 0 // 1 = render both screens offscreen on entry to log the emission ratio
+
+static lv_obj_t* screen_ambient = NULL;
+static lv_obj_t* ambient_cont;
+static lv_obj_t* ambient_time_label;
+static lv_obj_t* ambient_weight_label;
+static lv_obj_t* ambient_power_label;
+static lv_timer_t* ambient_timer = NULL;
+static lv_obj_t* ambient_return_screen = NULL; // Screen to restore on activity
+static uint8_t ambient_shift_index = 0;
+
+// Ambient session accounting, reported on exit
+static uint32_t ambient_enter_ms = 0;
+static uint32_t ambient_refreshes = 0;
+static uint32_t ambient_flush_mark = 0;
+static uint32_t ambient_wakeups_mark = 0;
+static uint32_t ambient_battery_mark_mv = 0;
+#if AMBIENT_MEASURE_EMISSION
+static float ambient_emission_ratio = 0.0f; // Lit pixels x brightness vs the screen it replaced
+#endif
+
+// --- Weight Readout ---
+#define WEIGHT_READOUT_USE_LABEL 0 // 1 = legacy single label, to compare bytes flushed per knob tick
+#define WEIGHT_READOUT_ANIM_MS 120 // Rolling digit animation length, 0 to disable
+
+#if !WEIGHT_READOUT_USE_LABEL
+static ui_digit_readout_t weight_readout;
+#endif
+static uint32_t weight_flush_mark = 0; // lcd_lvgl_get_flush_bytes() at the previous weight change
+
+// --- Weight Gauge ---
+#define WEIGHT_GAUGE_MIN 0          // Grams at the start of the ring
+#define WEIGHT_GAUGE_MAX 60         // Grams at the end of the ring
+#define WEIGHT_GAUGE_THICKNESS 10
+#define WEIGHT_GAUGE_START_DEG 150  // Clockwise from 3 o'clock; leaves the bottom free for presets/battery
+#define WEIGHT_GAUGE_SWEEP_DEG 240
+
+static ui_arc_gauge_t weight_gauge;
+
+
+// --- Shot Graph ---
+#define SHOT_GRAPH_WIDTH 300       // Pixel columns (one min/max pair each)
+#define SHOT_GRAPH_HEIGHT 110
+#define SHOT_GRAPH_DRAIN_BATCH 32  // Samples copied out of the ring per pass
+
+static ui_shot_graph_t shot_graph;
+static uint32_t shot_flush_mark = 0; // lcd_lvgl_get_flush_bytes() at shot start
 
 
 // --- Global State & UI Objects ---
 lv_obj_t* screen_shot_stopper;
 lv_obj_t* screen_ha;
 
+// Knob focus groups (the HA group lives and dies with the HA screen)
+#define HA_DESELECT_MS 5000 // Drop HA control focus after this long without a tap or detent
+static lv_group_t* shot_stopper_group = NULL;
+static lv_group_t* ha_group = NULL;
+
+// Target weight range and acceleration (1 g per detent when turned slowly, up to 5 g when spun)
+#define TARGET_WEIGHT_MIN 0
+#define TARGET_WEIGHT_MAX 100
+static const knob_accel_profile_t WEIGHT_ACCEL = {120, 25, 5};
+static knob_accel_t weight_accel = {&WEIGHT_ACCEL, 0, 0, 0};
+
 // HA Screen State
-static ha_control_t selected_ha_control = HA_CONTROL_NONE;
-static lv_timer_t* deselection_timer = NULL;
-static lv_style_t style_selected;
-static lv_obj_t* selected_ui_obj = NULL;
+static lv_timer_t* ha_deselect_timer = NULL;
 static lv_timer_t* power_long_press_timer = NULL; // Timer for power button
 static lv_timer_t* ha_debounce_timer = NULL;      // Timer for debouncing HA updates
 static ha_control_t debounced_control = HA_CONTROL_NONE; // Which control is being debounced
 
+// Knob acceleration per control: {slow_ms, fast_ms, max steps per detent}
+static const knob_accel_profile_t TEMP_ACCEL = {120, 25, 10};   // Up to 1.0 C per detent
+static const knob_accel_profile_t PREINF_ACCEL = {120, 30, 5};  // Up to 0.5 s per detent
+static knob_accel_t temp_accel = {&TEMP_ACCEL, 0, 0, 0};
+static knob_accel_t preinf_accel = {&PREINF_ACCEL, 0, 0, 0};
+
 // HA Screen UI Elements
 static lv_obj_t* ha_on_off_btn;
 static lv_obj_t* ha_mode_cont;
@@ -65,13 +176,31 @@ static lv_obj_t* ha_steam_cont;
 static lv_obj_t* ha_steam_label;
 static lv_obj_t* ha_last_shot_label;
 static lv_obj_t* ha_backflush_cont;
-
-// HA Value Cache
+static lv_obj_t* ha_idle_obj; // Focused when no control is selected (the last shot area)
+
+// Label bindings (cache the last rendered value per label)
+#if WEIGHT_READOUT_USE_LABEL
+static ui_label_binding_t weight_binding;
+#endif
+static ui_label_binding_t battery_binding;
+static ui_label_binding_t ha_mode_binding;
+static ui_label_binding_t ha_temp_binding;
+static ui_label_binding_t ha_steam_binding;
+static ui_label_binding_t ha_preinf_time_binding;
+static ui_label_binding_t ha_last_shot_binding;
+static int8_t battery_level_bucket = -1; // Index into BATTERY_LEVELS currently shown
+static int16_t battery_percentage = -1;   // Last percentage shown, -1 = none yet
+static char battery_suffix[16] = "%";     // "%" plus the runtime estimate
+
+// HA Value Cache. LVGL task only: written by the apply_* handlers (mailbox) and the
+// knob key handlers, read by the debounce lv_timer.
 static int8_t current_mode_index = 0;
 static const char* PREINFUSION_MODES[] = {"Pre-brew", "Pre-infusion", "Disabled"};
 static float current_temp = 93.0;
 static int8_t current_steam = 3;
 static float current_preinfusion_time = 0.8;
+static bool current_power = false;
+static float current_last_shot = 0.0;
 
 // Shot Stopper Screen Globals
 lv_obj_t * weight_label;
@@ -88,13 +217,27 @@ extern Preferences preferences; // Declare external Preferences object
 // Forward Declarations
 void create_ha_screen(lv_obj_t* parent);
 void create_shot_stopper_screen(lv_obj_t* parent);
-static void deselect_all_ha_controls();
-static void swipe_event_cb(lv_event_t* e);
+static void ha_deselect();
 void update_preset_label(uint8_t index); // Declare for use in create screen
 void load_presets(); // Declare for use in create screen
-static void battery_timer_cb(lv_timer_t* timer); // Battery timer callback
 static void inactivity_timer_cb(lv_timer_t* timer); // Inactivity timer callback
 void reset_inactivity_timer(); // Declaration for internal use
+static lv_obj_t* ensure_ha_screen();
+static void schedule_ha_teardown();
+static void apply_ha_power_switch(bool state);
+static void apply_ha_mode(int8_t mode_index);
+static void apply_ha_temperature(float temp);
+static void apply_ha_steam_power(int power);
+static void apply_ha_preinfusion_time(float time);
+static void apply_ha_last_shot(float seconds);
+static void apply_display_value(int8_t weight);
+static void apply_checkmark(bool visible);
+static void apply_ble_status(ble_status_t status);
+static void apply_battery_status(uint8_t percentage);
+static void apply_battery_runtime(uint16_t minutes);
+static void apply_power_profile();
+static void set_backlight(uint8_t duty);
+static bool apply_shot_samples();
 
 
 // --- Timer & Encoder Logic ---
@@ -126,74 +269,73 @@ static void ha_debounce_timer_cb(lv_timer_t* timer) {
     ha_debounce_timer = NULL; // Timer is one-shot, so just clear the handle
 }
 
+// Moves HA focus back to the idle object (nothing selected, knob does nothing)
+static void ha_deselect() {
+    if (ha_idle_obj) lv_group_focus_obj(ha_idle_obj);
+    if (ha_deselect_timer) lv_timer_pause(ha_deselect_timer);
+}
+
 // Timer callback to deselect the active HA control after 5 seconds of inactivity
 static void deselect_timer_cb(lv_timer_t* timer) {
     Serial.println("Deselection timer fired.");
-    deselect_all_ha_controls();
-    lv_timer_del(deselection_timer);
-    deselection_timer = NULL;
+    ha_deselect();
 }
 
 // Resets the 5-second HA deselection timer.
 void ha_ui_reset_deselection_timer() {
-    if (deselection_timer) {
-        lv_timer_reset(deselection_timer);
-    }
-}
-
-// Central handler for all encoder events on the Home Assistant screen
-void ha_ui_handle_encoder_turn(int8_t direction) {
-    reset_inactivity_timer(); // Reset brightness on encoder turn
-    if (selected_ha_control == HA_CONTROL_NONE || selected_ha_control == HA_CONTROL_BACKFLUSH) {
-        // Debouncing doesn't apply to backflush, handle it separately.
-        if (selected_ha_control == HA_CONTROL_BACKFLUSH) {
-            static int8_t backflush_counter = 0;
-            backflush_counter += direction;
-            if (abs(backflush_counter) >= 3) {
-                ha_trigger_backflush();
-                Serial.println("Backflush activated via encoder.");
-                deselect_all_ha_controls();
-                backflush_counter = 0;
-            }
+    if (ha_deselect_timer) {
+        lv_timer_reset(ha_deselect_timer);
+        lv_timer_resume(ha_deselect_timer);
+    }
+}
+
+// Applies one knob detent to an HA control. Mode, steam and backflush need 3
+// detents per step; the count lives in the control's user data and restarts
+// whenever the control gains focus.
+static void ha_control_turn(lv_obj_t* obj, ha_control_t control, int8_t direction) {
+    int32_t detents = (int32_t)(intptr_t)lv_obj_get_user_data(obj) + direction;
+    bool step = abs(detents) >= 3;
+    lv_obj_set_user_data(obj, (void*)(intptr_t)(step ? 0 : detents));
+
+    if (control == HA_CONTROL_BACKFLUSH) {
+        // Debouncing doesn't apply to backflush
+        if (step) {
+            ha_trigger_backflush();
+            Serial.println("Backflush activated via encoder.");
+            ha_deselect();
         }
         return;
     }
 
-    ha_ui_reset_deselection_timer(); // Reset HA control selection timer
-
     // Set the control that is being debounced
-    debounced_control = selected_ha_control;
-
-    static int8_t mode_counter = 0;
-    static int8_t steam_counter = 0;
+    debounced_control = control;
 
-    switch (selected_ha_control) {
+    switch (control) {
         case HA_CONTROL_MODE:
-            mode_counter += direction;
-            if (abs(mode_counter) >= 3) {
-                current_mode_index = (current_mode_index + (mode_counter > 0 ? 1 : -1) + 3) % 3;
-                update_ha_mode_ui(current_mode_index); // Update UI immediately
-                mode_counter = 0;
+            if (step) {
+                current_mode_index = (current_mode_index + (detents > 0 ? 1 : -1) + 3) % 3;
+                update_ha_mode_ui(current_mode_index); // Coalesced, applied once per LVGL cycle
             }
             break;
         case HA_CONTROL_PREINF_TIME:
-            current_preinfusion_time += (float)direction * 0.1;
-            if (current_preinfusion_time < 0.0) current_preinfusion_time = 0.0;
-            update_ha_preinfusion_time_ui(current_preinfusion_time); // Update UI immediately
+            current_preinfusion_time += (float)knob_accel_step(&preinf_accel, direction, ui_encoder_event_ms()) * 0.1;
+            if (current_preinfusion_time < HA_PREINF_TIME_MIN) current_preinfusion_time = HA_PREINF_TIME_MIN;
+            if (current_preinfusion_time > HA_PREINF_TIME_MAX) current_preinfusion_time = HA_PREINF_TIME_MAX;
+            update_ha_preinfusion_time_ui(current_preinfusion_time);
             break;
         case HA_CONTROL_TEMP:
-            current_temp += (float)direction * 0.1;
-            update_ha_temperature_ui(current_temp); // Update UI immediately
+            current_temp += (float)knob_accel_step(&temp_accel, direction, ui_encoder_event_ms()) * 0.1;
+            if (current_temp < HA_TEMP_MIN) current_temp = HA_TEMP_MIN;
+            if (current_temp > HA_TEMP_MAX) current_temp = HA_TEMP_MAX;
+            update_ha_temperature_ui(current_temp);
             break;
         case HA_CONTROL_STEAM:
-            steam_counter += direction;
-            if (abs(steam_counter) >= 3) {
-                int8_t new_steam = current_steam + (steam_counter > 0 ? 1 : -1);
+            if (step) {
+                int8_t new_steam = current_steam + (detents > 0 ? 1 : -1);
                 if (new_steam < 1) new_steam = 1;
                 if (new_steam > 3) new_steam = 3;
                 current_steam = new_steam;
-                update_ha_steam_power_ui(current_steam); // Update UI immediately
-                steam_counter = 0;
+                update_ha_steam_power_ui(current_steam);
             }
             break;
         default:
@@ -209,36 +351,274 @@ void ha_ui_handle_encoder_turn(int8_t direction) {
     }
 }
 
+// Which HA control an object is, HA_CONTROL_NONE for the idle object
+static ha_control_t ha_control_of(lv_obj_t* obj) {
+    if (obj == NULL || obj == ha_idle_obj) return HA_CONTROL_NONE;
+    if (obj == ha_mode_cont) return HA_CONTROL_MODE;
+    if (obj == ha_preinf_time_cont) return HA_CONTROL_PREINF_TIME;
+    if (obj == ha_backflush_cont) return HA_CONTROL_BACKFLUSH;
+    if (obj == ha_steam_cont) return HA_CONTROL_STEAM;
+    if (obj == ha_temp_cont) return HA_CONTROL_TEMP;
+    return HA_CONTROL_NONE;
+}
+
+// Focus hook (ui_encoder): selection side effects, once per real focus change. Not done on
+// LV_EVENT_FOCUSED: in edit mode lv_group_focus_obj() also sends that to the old control.
+static void ha_group_focused(lv_group_t* group) {
+    if (group != ha_group) return;
+    lv_obj_t* obj = lv_group_get_focused(group);
+    ha_control_t control = ha_control_of(obj);
+    if (control == HA_CONTROL_NONE) return; // ha_deselect() handles the timer
+    lv_obj_set_user_data(obj, (void*)0); // Fresh detent count
+    ha_ui_reset_deselection_timer();
+    Serial.printf("Selected control: %d\n", control);
+}
+
+// Events of a selectable HA control. Focus comes from LVGL's click focus (tap) or
+// ha_deselect(); knob detents arrive as LV_KEY_LEFT/RIGHT while it is focused.
+static void ha_control_event_cb(lv_event_t* e) {
+    lv_obj_t* obj = (lv_obj_t*)lv_event_get_target(e);
+    ha_control_t control = (ha_control_t)(intptr_t)lv_event_get_user_data(e);
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_FOCUSED: // Focus style only; selection is ha_group_focused()
+        case LV_EVENT_DEFOCUSED:
+            ui_transition_mark_dirty(screen_ha);
+            break;
+        case LV_EVENT_CLICKED:
+            reset_inactivity_timer(); // Reset brightness on touch
+            ha_ui_reset_deselection_timer();
+            break;
+        case LV_EVENT_KEY: {
+            uint32_t key = lv_event_get_key(e);
+            if (key != LV_KEY_LEFT && key != LV_KEY_RIGHT) break;
+            ha_ui_reset_deselection_timer(); // Reset HA control selection timer
+            ha_control_turn(obj, control, key == LV_KEY_RIGHT ? 1 : -1);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Knob detents on the Shot Stopper screen (the weight readout is its only group member)
+static void weight_key_event_cb(lv_event_t* e) {
+    uint32_t key = lv_event_get_key(e);
+    if (key != LV_KEY_LEFT && key != LV_KEY_RIGHT) return;
+
+    int32_t weight = target_weight + knob_accel_step(&weight_accel, key == LV_KEY_RIGHT ? 1 : -1,
+                                                     ui_encoder_event_ms());
+    if (weight < TARGET_WEIGHT_MIN) weight = TARGET_WEIGHT_MIN;
+    if (weight > TARGET_WEIGHT_MAX) weight = TARGET_WEIGHT_MAX;
+    if (weight == target_weight) return;
+    target_weight = (int8_t)weight;
+    hide_verification_checkmark();
+    update_display_value(target_weight); // Coalesced, applied once per LVGL cycle
+
+    // Don't write yet, just reset the debounce timer
+    if (ble_write_timer != NULL) {
+        xTimerReset(ble_write_timer, 0); // Timer service queue full: next detent retries
+    }
+}
+
+// --- Ambient Screen ---
+
+// Offsets cycled through once per refresh so no pixel stays lit in the same place
+static const int8_t AMBIENT_SHIFTS[][2] = {
+    {0, 0}, {AMBIENT_SHIFT_PX, 0}, {AMBIENT_SHIFT_PX, AMBIENT_SHIFT_PX}, {0, AMBIENT_SHIFT_PX},
+    {-AMBIENT_SHIFT_PX, AMBIENT_SHIFT_PX}, {-AMBIENT_SHIFT_PX, 0}, {-AMBIENT_SHIFT_PX, -AMBIENT_SHIFT_PX},
+    {0, -AMBIENT_SHIFT_PX}, {AMBIENT_SHIFT_PX, -AMBIENT_SHIFT_PX},
+};
+
+// Only pure black/white/primaries: the panel shows 8 colors in idle mode
+static void create_ambient_screen() {
+    screen_ambient = lv_obj_create(NULL);
+    ui_theme_style_screen(screen_ambient, lv_color_black());
+    lv_obj_clear_flag(screen_ambient, LV_OBJ_FLAG_SCROLLABLE);
+
+    ambient_cont = lv_obj_create(screen_ambient);
+    lv_obj_remove_style_all(ambient_cont);
+    lv_obj_set_size(ambient_cont, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(ambient_cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(ambient_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_row(ambient_cont, 6, 0);
+    lv_obj_align(ambient_cont, LV_ALIGN_CENTER, 0, 0);
+
+    ambient_time_label = lv_label_create(ambient_cont);
+    lv_obj_set_style_text_font(ambient_time_label, ui_font_large, 0);
+    lv_obj_set_style_text_color(ambient_time_label, lv_color_white(), 0);
+
+    ambient_weight_label = lv_label_create(ambient_cont);
+    lv_obj_set_style_text_font(ambient_weight_label, ui_font_medium, 0);
+    lv_obj_set_style_text_color(ambient_weight_label, lv_color_hex(0xffff00), 0);
+
+    ambient_power_label = lv_label_create(ambient_cont);
+    lv_obj_set_style_text_font(ambient_power_label, ui_font_small, 0);
+}
+
+// Milliseconds until the next wall-clock minute, or AMBIENT_REFRESH_MS if the clock isn't set
+static uint32_t ambient_ms_to_next_minute(bool* synced) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    *synced = tv.tv_sec > 1700000000; // SNTP has run (anything before late 2023 is the boot default)
+    if (!*synced) return AMBIENT_REFRESH_MS;
+    return (uint32_t)(60 - tv.tv_sec % 60) * 1000 - (uint32_t)(tv.tv_usec / 1000);
+}
+
+// Updates the labels and moves the content to the next burn-in offset.
+// Unchanged labels don't invalidate, so a refresh only flushes the old and new content box.
+static void ambient_refresh() {
+    bool synced;
+    uint32_t next_ms = ambient_ms_to_next_minute(&synced);
+
+    char buf[16];
+    if (synced) {
+        time_t now = time(NULL);
+        struct tm tm_now;
+        localtime_r(&now, &tm_now);
+        strftime(buf, sizeof(buf), "%H:%M", &tm_now);
+    } else {
+        snprintf(buf, sizeof(buf), "--:--");
+    }
+    if (strcmp(lv_label_get_text(ambient_time_label), buf) != 0) lv_label_set_text(ambient_time_label, buf);
+
+    snprintf(buf, sizeof(buf), "%d g", target_weight);
+    if (strcmp(lv_label_get_text(ambient_weight_label), buf) != 0) lv_label_set_text(ambient_weight_label, buf);
+
+    const char* power_text = current_power ? "Machine ON" : "Machine OFF";
+    if (strcmp(lv_label_get_text(ambient_power_label), power_text) != 0) {
+        lv_label_set_text(ambient_power_label, power_text);
+        lv_obj_set_style_text_color(ambient_power_label, current_power ? lv_color_hex(0x00ff00) : lv_color_hex(0xff0000), 0);
+    }
+
+    ambient_shift_index = (ambient_shift_index + 1) % (sizeof(AMBIENT_SHIFTS) / sizeof(AMBIENT_SHIFTS[0]));
+    lv_obj_align(ambient_cont, LV_ALIGN_CENTER, AMBIENT_SHIFTS[ambient_shift_index][0], AMBIENT_SHIFTS[ambient_shift_index][1]);
+
+    if (ambient_timer) lv_timer_set_period(ambient_timer, next_ms);
+}
+
+static void ambient_timer_cb(lv_timer_t* timer) {
+    ambient_refresh();
+    ambient_refreshes++;
+}
+
+// Replaces the active screen with the ambient clock and drops the panel/CPU into low power
+static void enter_ambient() {
+    if (!screen_ambient) create_ambient_screen();
+    ambient_return_screen = lv_scr_act();
+    ambient_refresh();
+
+#if AMBIENT_MEASURE_EMISSION
+    // Two full offscreen renders: debug only, not on every dim-to-ambient transition
+    ui_theme_measure_t ambient_m, normal_m;
+    if (ui_theme_measure_screen(screen_ambient, &ambient_m) &&
+        ui_theme_measure_screen(ambient_return_screen, &normal_m) && normal_m.emission_pct > 0) {
+        ambient_emission_ratio = ((float)ambient_m.emission_pct * BRIGHTNESS_AMBIENT) /
+                                 ((float)normal_m.emission_pct * BRIGHTNESS_HIGH);
+        Serial.printf("Ambient screen: %u%% lit vs %u%%, est. panel emission %.1f%% of the normal screen at full brightness\n",
+                      ambient_m.emission_pct, normal_m.emission_pct, ambient_emission_ratio * 100.0f);
+    }
+#endif
+
+    lv_screen_load(screen_ambient);
+    set_backlight(BRIGHTNESS_AMBIENT);
+    lcd_display_set_idle(true);
+    battery_monitor_set_period_ms(AMBIENT_BATTERY_PERIOD_MS);
+    bool synced;
+    ambient_timer = lv_timer_create(ambient_timer_cb, ambient_ms_to_next_minute(&synced), NULL);
+    encoder_set_sleep_wakeup(true); // Before light sleep is allowed
+    lcd_lvgl_set_low_power(true);
+
+    ambient_enter_ms = millis();
+    ambient_refreshes = 0;
+    ambient_flush_mark = lcd_lvgl_get_flush_bytes();
+    ambient_wakeups_mark = lcd_lvgl_get_wakeups_total();
+    battery_state_t battery;
+    ambient_battery_mark_mv = battery_monitor_get(&battery) ? battery.rest_mv : 0;
+    Serial.printf("[%lu] Entering ambient screen\n", ambient_enter_ms);
+}
+
+// Restores the previous screen and full power, then reports the ambient session
+static void exit_ambient() {
+    lcd_lvgl_set_low_power(false);
+    encoder_set_sleep_wakeup(false);
+    if (ambient_timer) {
+        lv_timer_del(ambient_timer);
+        ambient_timer = NULL;
+    }
+    lcd_display_set_idle(false);
+    if (ambient_return_screen != screen_ha || !screen_ha) ambient_return_screen = screen_shot_stopper;
+    lv_screen_load(ambient_return_screen);
+    battery_monitor_set_period_ms(BATTERY_MONITOR_PERIOD_MS); // Back to the normal rate, sampled right away
+
+    battery_state_t battery;
+    uint32_t battery_mv = battery_monitor_get(&battery) ? battery.rest_mv : 0;
+
+    uint32_t secs = (millis() - ambient_enter_ms) / 1000;
+    uint32_t flushed = lcd_lvgl_get_flush_bytes() - ambient_flush_mark;
+    uint32_t wakeups = lcd_lvgl_get_wakeups_total() - ambient_wakeups_mark;
+    float drop_mv_per_h = secs ? ((float)ambient_battery_mark_mv - (float)battery_mv) * 3600.0f / secs : 0.0f;
+    Serial.printf("Ambient session: %lu s, %lu refreshes, %lu bytes flushed (%lu/refresh), %.3f LVGL wakeups/s, "
+                  "battery %lu -> %lu mV (%.1f mV/h)\n",
+                  secs, ambient_refreshes, flushed, ambient_refreshes ? flushed / ambient_refreshes : 0,
+                  secs ? (float)wakeups / secs : 0.0f, ambient_battery_mark_mv, battery_mv, drop_mv_per_h);
+#if AMBIENT_MEASURE_EMISSION
+    Serial.printf("Ambient session: est. panel emission %.1f%%\n", ambient_emission_ratio * 100.0f);
+#endif
+}
+
 // --- Brightness Inactivity Logic ---
 
+// Sets the backlight, limited by the power profile's brightness cap
+static void set_backlight(uint8_t duty) {
+    setUpdutySubdivide(duty > brightness_cap ? brightness_cap : duty);
+}
+
 // Callback for the main inactivity timer
 static void inactivity_timer_cb(lv_timer_t* timer) {
     Serial.printf("Inactivity timer fired. Current brightness level: %d\n", current_brightness_level);
     if (current_brightness_level == BRIGHTNESS_HIGH) {
         Serial.println("Dimming screen to 20%");
-        setUpdutySubdivide(BRIGHTNESS_DIM);
+        set_backlight(BRIGHTNESS_DIM);
         current_brightness_level = BRIGHTNESS_DIM;
+        power_profile_set_screen(POWER_SCREEN_DIM);
         // Keep timer running, next timeout will turn screen off
-        lv_timer_set_period(timer, INACTIVITY_TIMEOUT_OFF_MS); // Set period for next stage
+        lv_timer_set_period(timer, inactivity_off_ms); // Set period for next stage
         lv_timer_reset(timer); // Reset countdown for the next stage
     } else if (current_brightness_level == BRIGHTNESS_DIM) {
-        Serial.println("Turning screen off");
-        setUpdutySubdivide(BRIGHTNESS_OFF);
+#if AMBIENT_SCREEN_ENABLED
+        enter_ambient();
+        current_brightness_level = BRIGHTNESS_AMBIENT;
+        power_profile_set_screen(POWER_SCREEN_AMBIENT);
+#else
+        Serial.printf("[%lu] Turning screen off, panel entering sleep\n", millis());
+        set_backlight(BRIGHTNESS_OFF);
+        lcd_display_set_sleep(true); // Stop panel scanning and LVGL rendering
         current_brightness_level = BRIGHTNESS_OFF;
+        power_profile_set_screen(POWER_SCREEN_OFF);
+#endif
         lv_timer_pause(timer); // Pause timer when screen is off
     }
 }
 
-// Function to reset brightness to high and restart the inactivity timer
+// Function to reset brightness to high and restart the inactivity timer.
+// LVGL task only: every caller is an LVGL event/timer, the touch read callback or
+// the knob drain in lvgl_display_process_updates().
 void reset_inactivity_timer() {
     if (current_brightness_level != BRIGHTNESS_HIGH) {
-        Serial.println("Activity detected, setting brightness to high.");
-        setUpdutySubdivide(BRIGHTNESS_HIGH);
+        Serial.printf("[%lu] Activity detected, setting brightness to high.\n", millis());
+        if (current_brightness_level == BRIGHTNESS_OFF) {
+            lcd_display_set_sleep(false); // Wake the panel, one coalesced redraw
+        } else if (current_brightness_level == BRIGHTNESS_AMBIENT) {
+            exit_ambient();
+        }
+        set_backlight(BRIGHTNESS_HIGH);
         current_brightness_level = BRIGHTNESS_HIGH;
+        power_profile_set_screen(POWER_SCREEN_ON);
     }
     if (inactivity_timer) {
         // Serial.println("Resetting inactivity timer."); // Debug log if needed
-        lv_timer_set_period(inactivity_timer, INACTIVITY_TIMEOUT_DIM_MS); // Reset period to initial dim timeout
+        lv_timer_set_period(inactivity_timer, inactivity_dim_ms); // Reset period to initial dim timeout
         lv_timer_reset(inactivity_timer); // Reset countdown
         lv_timer_resume(inactivity_timer); // Ensure it's running
     } else {
@@ -249,35 +629,6 @@ void reset_inactivity_timer() {
 
 // --- UI Creation & Event Handlers ---
 
-// Deselects any active HA control and removes its highlight
-static void deselect_all_ha_controls() {
-    if (selected_ui_obj) {
-        lv_obj_remove_style(selected_ui_obj, &style_selected, 0);
-        selected_ui_obj = NULL;
-    }
-    selected_ha_control = HA_CONTROL_NONE;
-}
-
-// Generic event handler for tapping a selectable HA control
-static void ha_select_event_cb(lv_event_t* e) {
-    reset_inactivity_timer(); // Reset brightness on touch
-    deselect_all_ha_controls();
-
-    ha_control_t control_type = (ha_control_t)(intptr_t)lv_event_get_user_data(e);
-    selected_ui_obj = (lv_obj_t*)lv_event_get_target(e); // Cast to lv_obj_t*
-
-    selected_ha_control = control_type;
-    lv_obj_add_style(selected_ui_obj, &style_selected, 0);
-    Serial.printf("Selected control: %d\n", control_type);
-
-    if (deselection_timer) {
-        lv_timer_reset(deselection_timer);
-    } else {
-        deselection_timer = lv_timer_create(deselect_timer_cb, 5000, NULL);
-        lv_timer_set_repeat_count(deselection_timer, 1);
-    }
-}
-
 // Manual long press implementation for power button
 static void power_long_press_timer_cb(lv_timer_t* timer) {
     bool current_state = lv_obj_has_state(ha_on_off_btn, LV_STATE_CHECKED);
@@ -306,36 +657,50 @@ static void ha_power_press_event_cb(lv_event_t* e) {
     }
 }
 
-// Event handler for screen swiping
-static void swipe_event_cb(lv_event_t* e) {
-    reset_inactivity_timer(); // Reset brightness on swipe
-    lv_indev_t * indev = lv_indev_active();
-    if(indev == NULL) return; // Should not happen with gestures
-
-    lv_dir_t dir = lv_indev_get_gesture_dir(indev);
-    Serial.printf("Swipe event detected! Direction: %d\n", dir); // DEBUG
-
+// Screen navigation for swipes and the background long press
+static void navigate_swipe(lv_dir_t dir) {
     if (dir == LV_DIR_TOP) {
         Serial.println("Swiped UP - Loading HA screen."); // DEBUG
-        lv_scr_load_anim(screen_ha, LV_SCR_LOAD_ANIM_MOVE_TOP, 300, 0, false);
+        if (ha_teardown_timer) lv_timer_pause(ha_teardown_timer);
+        ui_transition_start(ensure_ha_screen(), LV_DIR_TOP, 300);
     } else if (dir == LV_DIR_BOTTOM) {
         Serial.println("Swiped DOWN - Loading Shot Stopper screen."); // DEBUG
-        lv_scr_load_anim(screen_shot_stopper, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 300, 0, false);
+        ui_transition_start(screen_shot_stopper, LV_DIR_BOTTOM, 300);
+        schedule_ha_teardown();
     } else {
          Serial.println("Swipe direction not vertical."); // DEBUG
     }
 }
 
+// Gestures recognised by the touch driver, delivered from the touch read callback
+// (LVGL task, lock held) once per touch. Taps still go through normal LVGL pointer processing.
+void lvgl_display_handle_gesture(ui_gesture_t gesture, int32_t x, int32_t y) {
+    reset_inactivity_timer();
+    if (touch_calib_active()) {
+        return; // A swipe would load another screen over the calibration targets
+    }
+    switch (gesture) {
+        case UI_GESTURE_SWIPE_UP: navigate_swipe(LV_DIR_TOP); break;
+        case UI_GESTURE_SWIPE_DOWN: navigate_swipe(LV_DIR_BOTTOM); break;
+        case UI_GESTURE_LONG_PRESS: {
+            // Long press on empty background goes home; widgets keep their own long-press actions
+            lv_point_t point = {x, y};
+            lv_obj_t* pressed = lv_indev_search_obj(lv_scr_act(), &point);
+            if (lv_scr_act() == screen_ha && (pressed == NULL || pressed == screen_ha)) {
+                Serial.println("Long press on background - Loading Shot Stopper screen.");
+                navigate_swipe(LV_DIR_BOTTOM);
+            }
+            break;
+        }
+        default: break; // Left/right swipes have no screen to go to
+    }
+}
+
 // --- Home Assistant Screen Creation ---
 void create_ha_screen(lv_obj_t* parent) {
-    lv_obj_set_style_bg_color(parent, lv_color_hex(0x343a40), LV_PART_MAIN);
+    ui_theme_style_screen(parent, lv_color_hex(0x343a40));
     lv_obj_clear_flag(parent, LV_OBJ_FLAG_SCROLLABLE); // Ensure scrolling is off
 
-    lv_style_init(&style_selected);
-    lv_style_set_border_color(&style_selected, lv_color_hex(0x89cff0));
-    lv_style_set_border_width(&style_selected, 3);
-    lv_style_set_border_side(&style_selected, LV_BORDER_SIDE_FULL);
-
     // --- Reworked circular layout for 360x360 display ---
     const int btn_size = 80;
     const int radius = 130;
@@ -345,16 +710,21 @@ void create_ha_screen(lv_obj_t* parent) {
     // The caller is responsible for creating the label inside.
     auto create_circular_container = [&](ha_control_t ctrl_type) -> lv_obj_t* {
         lv_obj_t* btn = lv_btn_create(parent);
-        lv_obj_set_size(btn, btn_size, btn_size);
-        lv_obj_set_style_radius(btn, LV_RADIUS_CIRCLE, 0);
-        lv_obj_add_event_cb(btn, ha_select_event_cb, LV_EVENT_CLICKED, (void*)ctrl_type);
+        if (!ui_theme_style_button(btn)) lv_obj_set_style_radius(btn, LV_RADIUS_CIRCLE, 0);
+        lv_obj_set_size(btn, btn_size, btn_size); // After the theme: LITE removes all local styles
+        ui_theme_style_focusable(btn, true);
+        lv_obj_clear_flag(btn, LV_OBJ_FLAG_SCROLLABLE); // Knob keys must not scroll it
+        lv_obj_add_event_cb(btn, ha_control_event_cb, LV_EVENT_FOCUSED, (void*)ctrl_type);
+        lv_obj_add_event_cb(btn, ha_control_event_cb, LV_EVENT_DEFOCUSED, (void*)ctrl_type);
+        lv_obj_add_event_cb(btn, ha_control_event_cb, LV_EVENT_CLICKED, (void*)ctrl_type);
+        lv_obj_add_event_cb(btn, ha_control_event_cb, LV_EVENT_KEY, (void*)ctrl_type);
         return btn;
     };
 
     // 1. Power Button (Top)
     ha_on_off_btn = lv_btn_create(parent);
+    if (!ui_theme_style_button(ha_on_off_btn)) lv_obj_set_style_radius(ha_on_off_btn, LV_RADIUS_CIRCLE, 0);
     lv_obj_set_size(ha_on_off_btn, btn_size, btn_size);
-    lv_obj_set_style_radius(ha_on_off_btn, LV_RADIUS_CIRCLE, 0);
     lv_obj_align(ha_on_off_btn, LV_ALIGN_CENTER, 0, -radius);
     lv_obj_add_flag(ha_on_off_btn, LV_OBJ_FLAG_CHECKABLE);
     lv_obj_add_event_cb(ha_on_off_btn, ha_power_press_event_cb, LV_EVENT_ALL, NULL);
@@ -402,121 +772,208 @@ void create_ha_screen(lv_obj_t* parent) {
     lv_obj_center(ha_last_shot_label);
     lv_obj_set_style_text_align(ha_last_shot_label, LV_TEXT_ALIGN_CENTER, 0);
 
-    update_ha_mode_ui(current_mode_index);
-    update_ha_preinfusion_time_ui(current_preinfusion_time);
-    update_ha_temperature_ui(current_temp);
-    update_ha_steam_power_ui(current_steam);
-    update_ha_last_shot_ui(0);
+    // Knob group: the idle object goes first so it starts focused (nothing selected);
+    // tapping it also deselects. The power button stays out (touch only).
+    ha_idle_obj = last_shot_cont;
+    lv_obj_clear_flag(ha_idle_obj, LV_OBJ_FLAG_SCROLLABLE);
+    ui_theme_style_focusable(ha_idle_obj, false);
+    lv_group_add_obj(ha_group, ha_idle_obj);
+    lv_obj_t* controls[] = {ha_temp_cont, ha_mode_cont, ha_preinf_time_cont, ha_backflush_cont, ha_steam_cont};
+    for (lv_obj_t* control : controls) lv_group_add_obj(ha_group, control);
+
+    ui_binding_init(&ha_mode_binding, ha_mode_label, NULL, NULL, 0);
+    ui_binding_init(&ha_temp_binding, ha_temp_label, NULL, " C", 1);
+    ui_binding_init(&ha_steam_binding, ha_steam_label, "Pwr: ", NULL, 0);
+    ui_binding_init(&ha_preinf_time_binding, ha_preinf_time_label, NULL, "s", 1);
+    ui_binding_init(&ha_last_shot_binding, ha_last_shot_label, "Last: ", "s", 1);
+
+    // Widgets start from the value cache, so rebuilding the screen is cheap
+    apply_ha_power_switch(current_power);
+    apply_ha_mode(current_mode_index);
+    apply_ha_preinfusion_time(current_preinfusion_time);
+    apply_ha_temperature(current_temp);
+    apply_ha_steam_power(current_steam);
+    apply_ha_last_shot(current_last_shot);
 }
 
-// --- Battery Timer Callback ---
-static void battery_timer_cb(lv_timer_t* timer) {
-    // Read voltage (mV). The divider is 100k+100k, so Vbat = V_adc * 2
-    uint32_t current_reading_mv = analogReadMilliVolts(BATTERY_ADC_PIN) * 2;
-
-    // Initialize filter on first run
-    if (!battery_filter_initialized) {
-        for (int i = 0; i < BATTERY_READING_COUNT; i++) {
-            battery_readings[i] = current_reading_mv;
-        }
-        battery_reading_sum = current_reading_mv * BATTERY_READING_COUNT;
-        battery_filter_initialized = true;
-    } else {
-        // Subtract the oldest reading from the sum
-        battery_reading_sum -= battery_readings[battery_reading_index];
-        // Add the new reading to the sum
-        battery_reading_sum += current_reading_mv;
-        // Store the new reading, replacing the oldest
-        battery_readings[battery_reading_index] = current_reading_mv;
-    }
-
-    // Calculate the average voltage
-    uint32_t average_mv = battery_reading_sum / BATTERY_READING_COUNT;
-
-    // Move to the next index
-    battery_reading_index = (battery_reading_index + 1) % BATTERY_READING_COUNT;
-
+// Logs LVGL heap usage, tagged with what just happened
+static void log_lvgl_heap(const char* what) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    Serial.printf("LVGL heap after %s: %lu bytes used, %lu max used, %d%% frag\n", what,
+                  (unsigned long)(mon.total_size - mon.free_size), (unsigned long)mon.max_used, mon.frag_pct);
+}
 
-    // Calculate percentage based on the AVERAGE voltage
-    int percentage = (int)(((float)average_mv - BATTERY_MIN_MV) / (BATTERY_MAX_MV - BATTERY_MIN_MV) * 100.0f);
+// Builds the HA screen if it doesn't exist yet and returns it
+static lv_obj_t* ensure_ha_screen() {
+    if (screen_ha) return screen_ha;
 
-    // Clamp percentage between 0 and 100
-    if (percentage < 0) percentage = 0;
-    if (percentage > 100) percentage = 100;
+    uint32_t start_ms = millis();
+    screen_ha = lv_obj_create(NULL);
+    ha_group = ui_encoder_create_group();
+    create_ha_screen(screen_ha);
+    ui_encoder_attach_screen(screen_ha, ha_group);
+    ha_deselect_timer = lv_timer_create(deselect_timer_cb, HA_DESELECT_MS, NULL);
+    lv_timer_pause(ha_deselect_timer); // Runs while a control has focus
+    Serial.printf("HA screen built in %lu ms.\n", millis() - start_ms);
+    log_lvgl_heap("building HA screen");
+    return screen_ha;
+}
 
-    // Serial.printf("Battery mV (Avg): %lu, Percentage: %d%%\n", average_mv, percentage); // Debug
+// Deletes the HA screen and detaches everything that points into it
+static void ha_teardown_timer_cb(lv_timer_t* timer) {
+    ha_teardown_timer = NULL; // One-shot, LVGL deletes it after this callback
+    if (!screen_ha || lv_scr_act() == screen_ha || ui_transition_is_running()) return;
+
+    if (ha_deselect_timer) { lv_timer_del(ha_deselect_timer); ha_deselect_timer = NULL; }
+    if (power_long_press_timer) { lv_timer_del(power_long_press_timer); power_long_press_timer = NULL; }
+    lv_group_delete(ha_group); // Detaches the controls before they are deleted with the screen
+    ha_group = NULL;
+
+    ui_binding_unbind(&ha_mode_binding);
+    ui_binding_unbind(&ha_temp_binding);
+    ui_binding_unbind(&ha_steam_binding);
+    ui_binding_unbind(&ha_preinf_time_binding);
+    ui_binding_unbind(&ha_last_shot_binding);
+    ha_on_off_btn = ha_mode_cont = ha_mode_label = NULL;
+    ha_preinf_time_cont = ha_preinf_time_label = NULL;
+    ha_temp_cont = ha_temp_label = NULL;
+    ha_steam_cont = ha_steam_label = NULL;
+    ha_last_shot_label = ha_backflush_cont = ha_idle_obj = NULL;
+
+    ui_transition_forget(screen_ha);
+    lv_obj_del(screen_ha);
+    screen_ha = NULL;
+    log_lvgl_heap("tearing down HA screen");
+}
 
-    // Update the UI
-    update_battery_status((uint8_t)percentage);
+// (Re)starts the disuse countdown after leaving the HA screen
+static void schedule_ha_teardown() {
+    if (HA_SCREEN_TEARDOWN_MS == 0 || !screen_ha) return;
+    if (ha_teardown_timer) {
+        lv_timer_reset(ha_teardown_timer);
+        lv_timer_resume(ha_teardown_timer);
+    } else {
+        ha_teardown_timer = lv_timer_create(ha_teardown_timer_cb, HA_SCREEN_TEARDOWN_MS, NULL);
+        lv_timer_set_repeat_count(ha_teardown_timer, 1);
+    }
 }
 
+// Logs boot-to-first-frame once, when the first full refresh completes
+static void first_frame_cb(lv_event_t* e) {
+    if (first_frame_logged) return;
+    first_frame_logged = true;
+    Serial.printf("First frame on panel %lu ms after boot.\n", millis());
+}
 
 // --- Main Initialization ---
 void lvgl_display_init() {
     // Note: lv_init() is called in lcd_lvgl_Init() in lcd_bsp.c
+    ui_fonts_init();
+    ui_theme_init((ui_theme_mode_t)preferences.getChar(UI_THEME_NVS_KEY, UI_THEME_DEFAULT));
 
     screen_shot_stopper = lv_obj_create(NULL);
-    screen_ha = lv_obj_create(NULL);
-
     create_shot_stopper_screen(screen_shot_stopper);
-    create_ha_screen(screen_ha);
 
-    // Removed GESTURE_BUBBLE flags
-    // lv_obj_add_flag(screen_shot_stopper, LV_OBJ_FLAG_GESTURE_BUBBLE);
-    // lv_obj_add_flag(screen_ha, LV_OBJ_FLAG_GESTURE_BUBBLE);
 
-    // Add event callbacks directly to screens
-    lv_obj_add_event_cb(screen_shot_stopper, swipe_event_cb, LV_EVENT_GESTURE, NULL);
-    lv_obj_add_event_cb(screen_ha, swipe_event_cb, LV_EVENT_GESTURE, NULL);
+    // Knob: the weight readout is the Shot Stopper screen's only focusable object
+    ui_encoder_init();
+    ui_encoder_set_focus_hook(ha_group_focused);
+    shot_stopper_group = ui_encoder_create_group();
+    lv_obj_clear_flag(weight_label, LV_OBJ_FLAG_SCROLLABLE);
+    ui_theme_style_focusable(weight_label, false);
+    lv_obj_add_event_cb(weight_label, weight_key_event_cb, LV_EVENT_KEY, NULL);
+    lv_group_add_obj(shot_stopper_group, weight_label);
+    ui_encoder_attach_screen(screen_shot_stopper, shot_stopper_group);
 
-    lv_disp_load_scr(screen_shot_stopper);
+    screen_ha = NULL;
+    #if !HA_SCREEN_LAZY
+    ensure_ha_screen();
+    #endif
+    log_lvgl_heap("UI init");
+    lv_display_add_event_cb(lv_display_get_default(), first_frame_cb, LV_EVENT_REFR_READY, NULL);
 
-    // Create a timer to update the battery status every 5 seconds (5000 ms)
-    lv_timer_create(battery_timer_cb, 5000, NULL);
-    // Call it once immediately to show initial status
-    battery_timer_cb(NULL); // Call initial update
-    Serial.println("Battery update timer created."); // Confirm timer creation
+    lv_disp_load_scr(screen_shot_stopper);
+    ui_transition_init();
 
     // Create the main inactivity timer, initially set for the first dim timeout
-    inactivity_timer = lv_timer_create(inactivity_timer_cb, INACTIVITY_TIMEOUT_DIM_MS, NULL);
+    inactivity_timer = lv_timer_create(inactivity_timer_cb, inactivity_dim_ms, NULL);
     Serial.println("Inactivity timer created.");
 
 }
 
+// --- Cross-Task UI Updates ---
+
+// Called by the LVGL task (lock held) once per cycle, before lv_timer_handler().
+// Applies the latest value of every widget that was updated since the last cycle.
+void lvgl_display_process_updates() {
+    if (apply_shot_samples()) ui_transition_mark_dirty(screen_shot_stopper);
+    if (ui_mailbox_knob_pending() > 0) {
+        reset_inactivity_timer(); // Wake/exit ambient first, so the detents reach the real screen
+        ui_encoder_process(); // Key handlers post to the mailbox, drained just below
+    }
+
+    ui_msg_value_t values[UI_MSG_COUNT];
+    uint32_t pending = ui_mailbox_take(values);
+    if (pending == 0) return;
+
+    if (pending & (1UL << UI_MSG_WEIGHT)) apply_display_value((int8_t)values[UI_MSG_WEIGHT].i);
+    if (pending & (1UL << UI_MSG_CHECKMARK)) apply_checkmark(values[UI_MSG_CHECKMARK].b);
+    if (pending & (1UL << UI_MSG_BLE_STATUS)) apply_ble_status((ble_status_t)values[UI_MSG_BLE_STATUS].i);
+    if (pending & (1UL << UI_MSG_BATTERY)) apply_battery_status((uint8_t)values[UI_MSG_BATTERY].i);
+    if (pending & (1UL << UI_MSG_BATTERY_RUNTIME)) apply_battery_runtime((uint16_t)values[UI_MSG_BATTERY_RUNTIME].i);
+    if (pending & (1UL << UI_MSG_POWER_PROFILE)) apply_power_profile();
+    if (pending & (1UL << UI_MSG_HA_POWER)) apply_ha_power_switch(values[UI_MSG_HA_POWER].b);
+    if (pending & (1UL << UI_MSG_HA_MODE)) apply_ha_mode((int8_t)values[UI_MSG_HA_MODE].i);
+    if (pending & (1UL << UI_MSG_HA_TEMP)) apply_ha_temperature(values[UI_MSG_HA_TEMP].f);
+    if (pending & (1UL << UI_MSG_HA_STEAM)) apply_ha_steam_power(values[UI_MSG_HA_STEAM].i);
+    if (pending & (1UL << UI_MSG_HA_PREINF_TIME)) apply_ha_preinfusion_time(values[UI_MSG_HA_PREINF_TIME].f);
+    if (pending & (1UL << UI_MSG_HA_LAST_SHOT)) apply_ha_last_shot(values[UI_MSG_HA_LAST_SHOT].f);
+
+    // Cached transition snapshots of the affected screens are now stale
+    const uint32_t shot_stopper_msgs = (1UL << UI_MSG_WEIGHT) | (1UL << UI_MSG_CHECKMARK) |
+                                       (1UL << UI_MSG_BLE_STATUS) | (1UL << UI_MSG_BATTERY) |
+                                       (1UL << UI_MSG_BATTERY_RUNTIME);
+    const uint32_t no_widget_msgs = (1UL << UI_MSG_POWER_PROFILE);
+    if (pending & shot_stopper_msgs) ui_transition_mark_dirty(screen_shot_stopper);
+    if (pending & ~(shot_stopper_msgs | no_widget_msgs)) ui_transition_mark_dirty(screen_ha);
+}
+
 // --- HA UI Update Functions ---
-void update_ha_power_switch_ui(bool state) {
+// Public versions are safe to call from any task; they only post to the mailbox.
+void update_ha_power_switch_ui(bool state) { ui_mailbox_post_bool(UI_MSG_HA_POWER, state); }
+void update_ha_mode_ui(int8_t mode_index) { ui_mailbox_post_int(UI_MSG_HA_MODE, mode_index); }
+void update_ha_temperature_ui(float temp) { ui_mailbox_post_float(UI_MSG_HA_TEMP, temp); }
+void update_ha_steam_power_ui(int power) { ui_mailbox_post_int(UI_MSG_HA_STEAM, power); }
+void update_ha_preinfusion_time_ui(float time) { ui_mailbox_post_float(UI_MSG_HA_PREINF_TIME, time); }
+void update_ha_last_shot_ui(float seconds) { ui_mailbox_post_float(UI_MSG_HA_LAST_SHOT, seconds); }
+
+static void apply_ha_power_switch(bool state) {
+    current_power = state;
     if (ha_on_off_btn) {
         state ? lv_obj_add_state(ha_on_off_btn, LV_STATE_CHECKED) : lv_obj_clear_state(ha_on_off_btn, LV_STATE_CHECKED);
     }
 }
-void update_ha_mode_ui(int8_t mode_index) {
+static void apply_ha_mode(int8_t mode_index) {
+    if (mode_index < 0 || mode_index > 2) return;
     current_mode_index = mode_index;
-    if (ha_mode_label) {
-        lv_label_set_text(ha_mode_label, PREINFUSION_MODES[current_mode_index]);
-    }
+    ui_binding_set_text(&ha_mode_binding, current_mode_index, PREINFUSION_MODES[current_mode_index]);
 }
-void update_ha_temperature_ui(float temp) {
+static void apply_ha_temperature(float temp) {
     current_temp = temp;
-    if (ha_temp_label) {
-        lv_label_set_text_fmt(ha_temp_label, "%.1f C", current_temp);
-    }
+    ui_binding_set_float(&ha_temp_binding, current_temp);
 }
-void update_ha_steam_power_ui(int power) {
+static void apply_ha_steam_power(int power) {
     current_steam = power;
-    if (ha_steam_label) {
-        lv_label_set_text_fmt(ha_steam_label, "Pwr: %d", current_steam);
-    }
+    ui_binding_set_fixed(&ha_steam_binding, current_steam);
 }
-void update_ha_preinfusion_time_ui(float time) {
+static void apply_ha_preinfusion_time(float time) {
     current_preinfusion_time = time;
-    if (ha_preinf_time_label) {
-        lv_label_set_text_fmt(ha_preinf_time_label, "%.1fs", current_preinfusion_time);
-    }
+    ui_binding_set_float(&ha_preinf_time_binding, current_preinfusion_time);
 }
-void update_ha_last_shot_ui(float seconds) {
-    if (ha_last_shot_label) {
-        lv_label_set_text_fmt(ha_last_shot_label, "Last: %.1fs", seconds);
-    }
+static void apply_ha_last_shot(float seconds) {
+    current_last_shot = seconds;
+    ui_binding_set_float(&ha_last_shot_binding, seconds);
 }
 
 // --- Shot Stopper Screen Code ---
@@ -585,43 +1042,61 @@ static void preset_event_cb(lv_event_t * e) {
 
 // Create the Shot Stopper Screen UI
 void create_shot_stopper_screen(lv_obj_t* parent) {
-    lv_obj_set_style_bg_color(parent, lv_color_black(), LV_PART_MAIN);
+    ui_theme_style_screen(parent, lv_color_black());
     lv_obj_clear_flag(parent, LV_OBJ_FLAG_SCROLLABLE); // Explicitly disable scroll
 
     ble_status_label = lv_label_create(parent);
     // Use symbol as requested
     lv_label_set_text(ble_status_label, LV_SYMBOL_BLUETOOTH);
-    // Use lv_font_montserrat_24 for the BLE icon text as requested
-    lv_obj_set_style_text_font(ble_status_label, &lv_font_montserrat_24, 0);
+    // Use the 24 px font for the BLE icon text as requested
+    lv_obj_set_style_text_font(ble_status_label, ui_font_medium, 0);
     // Use lv_color_make for initial grey color
     lv_obj_set_style_text_color(ble_status_label, lv_color_make(128, 128, 128), 0); // Default grey
-    lv_obj_align(ble_status_label, LV_ALIGN_TOP_MID, 0, 10);
+    lv_obj_align(ble_status_label, LV_ALIGN_TOP_MID, 0, 16); // Clear of the weight gauge ring
 
     title_label = lv_label_create(parent);
     lv_label_set_text(title_label, "Target Weight (g)");
-    // Use lv_font_montserrat_24 as requested by user
-    lv_obj_set_style_text_font(title_label, &lv_font_montserrat_24, 0);
+    // Use the 24 px font as requested by user
+    lv_obj_set_style_text_font(title_label, ui_font_medium, 0);
     lv_obj_set_style_text_color(title_label, lv_color_white(), 0);
     lv_obj_align(title_label, LV_ALIGN_TOP_MID, 0, 50); // Adjusted Y position
 
+    // 48 px font (ui_fonts falls back to 24 px if LV_FONT_MONTSERRAT_48 is off in lv_conf.h)
+    const lv_font_t* weight_font = ui_font_large;
+    #if WEIGHT_READOUT_USE_LABEL
     weight_label = lv_label_create(parent);
     lv_label_set_text(weight_label, "...");
-    // Use lv_font_montserrat_48 if enabled in lv_conf.h, otherwise fallback
-    // NOTE: Ensure LV_FONT_MONTSERRAT_48 is set to 1 in lv_conf.h
-    #if LV_FONT_MONTSERRAT_48
-    lv_obj_set_style_text_font(weight_label, &lv_font_montserrat_48, 0);
+    lv_obj_set_style_text_font(weight_label, weight_font, 0);
+    lv_obj_set_style_text_color(weight_label, lv_color_white(), 0);
+    ui_binding_init(&weight_binding, weight_label, NULL, " g", 0);
     #else
-    // Fallback if 48 is not enabled
-    lv_obj_set_style_text_font(weight_label, &lv_font_montserrat_24, 0); // Use 24 as a fallback
-    #warning "LV_FONT_MONTSERRAT_48 not enabled in lv_conf.h, using smaller font for weight."
+    ui_digit_readout_create(&weight_readout, parent, weight_font, lv_color_white(), "g", WEIGHT_READOUT_ANIM_MS);
+    ui_digit_readout_set_text(&weight_readout, "...");
+    weight_label = weight_readout.root;
     #endif
-    lv_obj_set_style_text_color(weight_label, lv_color_white(), 0);
     lv_obj_align(weight_label, LV_ALIGN_CENTER, 0, -30); // Keep centered
 
+    // Shot graph sits behind the weight and only appears once a shot starts
+    ui_shot_graph_create(&shot_graph, parent, SHOT_GRAPH_WIDTH, SHOT_GRAPH_HEIGHT, lv_color_hex(0x1e6f5c));
+    lv_obj_align(shot_graph.obj, LV_ALIGN_CENTER, 0, -30);
+    lv_obj_move_to_index(shot_graph.obj, 0);
+    lv_obj_add_flag(shot_graph.obj, LV_OBJ_FLAG_HIDDEN);
+
+    // Target weight ring around the panel edge, behind everything else
+    if (ui_arc_gauge_create(&weight_gauge, parent, EXAMPLE_LCD_H_RES, WEIGHT_GAUGE_THICKNESS,
+                            WEIGHT_GAUGE_START_DEG, WEIGHT_GAUGE_SWEEP_DEG,
+                            lv_color_hex(0x202020), lv_color_hex(0xd08a2a))) {
+        ui_arc_gauge_set_range(&weight_gauge, WEIGHT_GAUGE_MIN, WEIGHT_GAUGE_MAX);
+        lv_obj_center(weight_gauge.obj);
+        lv_obj_move_to_index(weight_gauge.obj, 0);
+    } else {
+        Serial.println("Error: not enough memory for the weight gauge masks!");
+    }
+
     checkmark_label = lv_label_create(parent);
     lv_label_set_text(checkmark_label, LV_SYMBOL_OK);
-    // Use lv_font_montserrat_24 as requested by user
-    lv_obj_set_style_text_font(checkmark_label, &lv_font_montserrat_24, 0); // Size matches title
+    // Use the 24 px font as requested by user
+    lv_obj_set_style_text_font(checkmark_label, ui_font_medium, 0); // Size matches title
     lv_obj_set_style_text_color(checkmark_label, lv_palette_main(LV_PALETTE_GREEN), 0);
     lv_obj_align_to(checkmark_label, weight_label, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
     lv_obj_add_flag(checkmark_label, LV_OBJ_FLAG_HIDDEN);
@@ -635,15 +1110,17 @@ void create_shot_stopper_screen(lv_obj_t* parent) {
 
     for (int i = 0; i < 3; i++) {
         preset_btns[i] = lv_btn_create(preset_container);
-        lv_obj_set_size(preset_btns[i], 90, 60);
+        if (!ui_theme_style_button(preset_btns[i])) {
+            // Use lv_palette_main(LV_PALETTE_GREY) for background
+            lv_obj_set_style_bg_color(preset_btns[i], lv_palette_main(LV_PALETTE_GREY), 0); // Standard grey
+        }
+        lv_obj_set_size(preset_btns[i], 90, 60); // After the theme: LITE removes all local styles
         lv_obj_add_event_cb(preset_btns[i], preset_event_cb, LV_EVENT_ALL, (void*)(intptr_t)i);
-        // Use lv_palette_main(LV_PALETTE_GREY) for background
-        lv_obj_set_style_bg_color(preset_btns[i], lv_palette_main(LV_PALETTE_GREY), 0); // Standard grey
 
         preset_labels[i] = lv_label_create(preset_btns[i]);
         lv_obj_center(preset_labels[i]);
         // Set font for preset labels
-        lv_obj_set_style_text_font(preset_labels[i], &lv_font_montserrat_24, 0); // Consistent size requested by user
+        lv_obj_set_style_text_font(preset_labels[i], ui_font_medium, 0); // Consistent size requested by user
         // Set preset label text color
         lv_obj_set_style_text_color(preset_labels[i], lv_color_white(), 0); // White text
     }
@@ -651,39 +1128,65 @@ void create_shot_stopper_screen(lv_obj_t* parent) {
     // Create Battery Label
     battery_label = lv_label_create(parent);
     lv_label_set_text(battery_label, "Batt: --%");
-    lv_obj_set_style_text_font(battery_label, &lv_font_montserrat_16, 0); // Use a smaller font
+    lv_obj_set_style_text_font(battery_label, ui_font_small, 0); // Use a smaller font
     lv_obj_set_style_text_color(battery_label, lv_color_white(), 0);
     lv_obj_align(battery_label, LV_ALIGN_BOTTOM_MID, 0, -20); // Position bottom
+    ui_binding_init(&battery_binding, battery_label, "Batt: ", battery_suffix, 0);
+    battery_level_bucket = -1;
 
 
     // Load presets after creating labels
     load_presets();
 }
 
+// --- Shot Stopper UI Update Functions ---
+// Public versions are safe to call from any task; they only post to the mailbox.
+void update_display_value(int8_t weight) { ui_mailbox_post_int(UI_MSG_WEIGHT, weight); }
+void show_verification_checkmark() { ui_mailbox_post_bool(UI_MSG_CHECKMARK, true); }
+void hide_verification_checkmark() { ui_mailbox_post_bool(UI_MSG_CHECKMARK, false); }
+void update_ble_status(ble_status_t status) { ui_mailbox_post_int(UI_MSG_BLE_STATUS, status); }
+void update_battery_status(uint8_t percentage) { ui_mailbox_post_int(UI_MSG_BATTERY, percentage); }
+void update_battery_runtime(uint16_t minutes) { ui_mailbox_post_int(UI_MSG_BATTERY_RUNTIME, minutes); }
+void update_power_profile_ui(bool low_power) { ui_mailbox_post_bool(UI_MSG_POWER_PROFILE, low_power); }
+// Shot samples keep every value in order, so they use the sample ring rather than a slot
+void start_shot_graph() { ui_mailbox_push_sample(UI_SAMPLE_START, millis(), 0); }
+void add_shot_sample(float grams, uint32_t t_ms) { ui_mailbox_push_sample(UI_SAMPLE_VALUE, t_ms, grams); }
+void stop_shot_graph() { ui_mailbox_push_sample(UI_SAMPLE_END, millis(), 0); }
+
 // Update the main weight display
-void update_display_value(int8_t weight) {
-    if(weight_label) {
-        lv_label_set_text_fmt(weight_label, "%d g", weight);
-        Serial.printf("Display updated to: %d g\n", weight);
+// Also the only place a weight from another task (BLE read) becomes target_weight,
+// so the knob's read-modify-write on the LVGL task never races it.
+static void apply_display_value(int8_t weight) {
+    target_weight = weight;
+    #if WEIGHT_READOUT_USE_LABEL
+    bool changed = ui_binding_set_fixed(&weight_binding, weight);
+    #else
+    bool changed = ui_digit_readout_set_value(&weight_readout, weight);
+    #endif
+    ui_arc_gauge_set_value(&weight_gauge, weight);
+    if (changed) {
+        // Bytes flushed since the previous change, i.e. the cost of redrawing the previous tick
+        uint32_t flushed = lcd_lvgl_get_flush_bytes();
+        Serial.printf("Display updated to: %d g (%lu bytes flushed since last update)\n",
+                      weight, (unsigned long)(flushed - weight_flush_mark));
+        weight_flush_mark = flushed;
     }
 }
 
 // Show/Hide checkmark
-void show_verification_checkmark() {
-    if (checkmark_label) {
+static void apply_checkmark(bool visible) {
+    if (!checkmark_label) return;
+    if (visible) {
         lv_obj_clear_flag(checkmark_label, LV_OBJ_FLAG_HIDDEN);
         Serial.println("Checkmark displayed.");
-    }
-}
-void hide_verification_checkmark() {
-    if (checkmark_label) {
+    } else {
         lv_obj_add_flag(checkmark_label, LV_OBJ_FLAG_HIDDEN);
         Serial.println("Checkmark hidden.");
     }
 }
 
 // Update BLE status icon color
-void update_ble_status(ble_status_t status) {
+static void apply_ble_status(ble_status_t status) {
     if (!ble_status_label) return;
     // Use lv_color_make for status colors
     switch (status) {
@@ -702,34 +1205,103 @@ void update_ble_status(ble_status_t status) {
     }
 }
 
-// New function to update battery status label
-void update_battery_status(uint8_t percentage) {
-    if (battery_label) {
-        // Use battery symbol if available in font, otherwise just text
-        #ifdef LV_SYMBOL_BATTERY_FULL // Check if symbol is defined
-            // Simple logic: show different symbols based on percentage
-            if (percentage > 85) {
-                lv_label_set_text_fmt(battery_label, LV_SYMBOL_BATTERY_FULL " %d%%", percentage);
-                lv_obj_set_style_text_color(battery_label, lv_color_make(0, 255, 0), 0);
-            } else if (percentage > 60) {
-                 lv_label_set_text_fmt(battery_label, LV_SYMBOL_BATTERY_3 " %d%%", percentage);
-                 lv_obj_set_style_text_color(battery_label, lv_color_make(123, 255, 0), 0);
-            } else if (percentage > 30) {
-                 lv_label_set_text_fmt(battery_label, LV_SYMBOL_BATTERY_2 " %d%%", percentage);
-                 lv_obj_set_style_text_color(battery_label, lv_color_make(217, 255, 0), 0);
-            } else if (percentage > 15) {
-                 lv_label_set_text_fmt(battery_label, LV_SYMBOL_BATTERY_1 " %d%%", percentage);
-                 lv_obj_set_style_text_color(battery_label, lv_color_make(255, 157, 0), 0);
-            } else {
-                 lv_label_set_text_fmt(battery_label, LV_SYMBOL_BATTERY_EMPTY " %d%%", percentage);
-                 lv_obj_set_style_text_color(battery_label, lv_color_make(255, 0, 0), 0);
-            }
-        #else // Fallback if symbols aren't defined/enabled
-            lv_label_set_text_fmt(battery_label, "Batt: %d%%", percentage);
-        #endif
-       // Serial.printf("Updating battery label: %d%%\n", percentage); // Debug
+// Battery symbol/color per charge band, highest band first
+#ifdef LV_SYMBOL_BATTERY_FULL // Check if symbol is defined
+static const struct {
+    uint8_t above_pct;
+    const char* prefix;
+    uint8_t r, g, b;
+} BATTERY_LEVELS[] = {
+    {85, LV_SYMBOL_BATTERY_FULL " ", 0, 255, 0},
+    {60, LV_SYMBOL_BATTERY_3 " ", 123, 255, 0},
+    {30, LV_SYMBOL_BATTERY_2 " ", 217, 255, 0},
+    {15, LV_SYMBOL_BATTERY_1 " ", 255, 157, 0},
+    {0, LV_SYMBOL_BATTERY_EMPTY " ", 255, 0, 0},
+};
+#endif
+
+// Update battery status label
+static void apply_battery_status(uint8_t percentage) {
+    if (!battery_label) return;
+    // Use battery symbol if available in font, otherwise just text
+    #ifdef LV_SYMBOL_BATTERY_FULL
+        int8_t bucket = 0;
+        const int8_t last_bucket = (int8_t)(sizeof(BATTERY_LEVELS) / sizeof(BATTERY_LEVELS[0])) - 1;
+        while (bucket < last_bucket && percentage <= BATTERY_LEVELS[bucket].above_pct) {
+            bucket++;
+        }
+        if (bucket != battery_level_bucket) {
+            // Symbol and color only change when crossing a band
+            battery_binding.prefix = BATTERY_LEVELS[bucket].prefix;
+            ui_binding_mark_stale(&battery_binding);
+            lv_obj_set_style_text_color(battery_label,
+                lv_color_make(BATTERY_LEVELS[bucket].r, BATTERY_LEVELS[bucket].g, BATTERY_LEVELS[bucket].b), 0);
+            battery_level_bucket = bucket;
+        }
+    #endif
+    ui_binding_set_fixed(&battery_binding, percentage);
+    battery_percentage = percentage;
+}
+
+// Appends the runtime estimate to the battery label, e.g. "Batt: 70% 3h20m"
+static void apply_battery_runtime(uint16_t minutes) {
+    if (minutes == POWER_RUNTIME_UNKNOWN) {
+        snprintf(battery_suffix, sizeof(battery_suffix), "%%");
+    } else if (minutes >= 60) {
+        snprintf(battery_suffix, sizeof(battery_suffix), "%% %uh%02um", minutes / 60, minutes % 60);
     } else {
-       // Serial.println("Battery label object does not exist!"); // Debug
+        snprintf(battery_suffix, sizeof(battery_suffix), "%% %um", minutes);
     }
+    if (!battery_label || battery_percentage < 0) return; // Rendered with the first percentage
+    ui_binding_mark_stale(&battery_binding);
+    ui_binding_set_fixed(&battery_binding, battery_percentage);
 }
 
+// Applies the power profile's inactivity timeouts and brightness cap
+static void apply_power_profile() {
+    const power_profile_t* profile = power_profile_current();
+    Serial.printf("[%lu] Display using the %s power profile\n", millis(), profile->name);
+    inactivity_dim_ms = profile->dim_timeout_ms;
+    inactivity_off_ms = profile->off_timeout_ms;
+    brightness_cap = profile->brightness_cap;
+    if (current_brightness_level == BRIGHTNESS_HIGH || current_brightness_level == BRIGHTNESS_DIM) {
+        set_backlight(current_brightness_level);
+    }
+    if (inactivity_timer && current_brightness_level == BRIGHTNESS_HIGH) {
+        lv_timer_set_period(inactivity_timer, inactivity_dim_ms);
+        lv_timer_reset(inactivity_timer);
+    }
+}
+
+// Drains the sample ring into the shot graph. Returns true if anything was applied.
+static bool apply_shot_samples() {
+    ui_sample_t batch[SHOT_GRAPH_DRAIN_BATCH];
+    uint32_t count;
+    bool applied = false;
+    while ((count = ui_mailbox_pop_samples(batch, SHOT_GRAPH_DRAIN_BATCH)) > 0) {
+        if (!shot_graph.obj) continue; // Screen not built yet, discard
+        applied = true;
+        for (uint32_t i = 0; i < count; i++) {
+            const ui_sample_t& sample = batch[i];
+            if (sample.kind == UI_SAMPLE_START) {
+                ui_shot_graph_begin(&shot_graph, sample.t_ms, target_weight);
+                lv_obj_clear_flag(shot_graph.obj, LV_OBJ_FLAG_HIDDEN);
+                shot_flush_mark = lcd_lvgl_get_flush_bytes();
+                Serial.println("Shot graph started.");
+            } else if (sample.kind == UI_SAMPLE_END) {
+                uint32_t pushed, dropped;
+                ui_mailbox_get_sample_stats(&pushed, &dropped);
+                Serial.printf("Shot graph stopped: %lu samples, %lu ms/column, %lu column redraws, "
+                              "%lu full redraws, %lu bytes flushed, %lu samples dropped in total\n",
+                              (unsigned long)shot_graph.samples, (unsigned long)shot_graph.ms_per_col,
+                              (unsigned long)shot_graph.columns_invalidated,
+                              (unsigned long)shot_graph.full_redraws,
+                              (unsigned long)(lcd_lvgl_get_flush_bytes() - shot_flush_mark),
+                              (unsigned long)dropped);
+            } else {
+                ui_shot_graph_add(&shot_graph, sample.t_ms, sample.value);
+            }
+        }
+    }
+    return applied;
+}
@@ -4,6 +4,10 @@
  * Declares the functions for initializing the UI and updating its elements.
  * Added update_battery_status function.
  * Added reset_inactivity_timer function.
+ * Update functions are thread-safe: they post to the UI mailbox and return immediately.
+ * Added lvgl_display_handle_gesture() for hardware touch gestures.
+ * The knob drives LVGL focus groups (ui_encoder) instead of an HA encoder handler.
+ * Added update_battery_runtime() and update_power_profile_ui().
  */
 #ifndef LVGL_DISPLAY_H
 #define LVGL_DISPLAY_H
@@ -25,6 +29,16 @@ typedef enum {
     HA_CONTROL_BACKFLUSH
 } ha_control_t;
 
+// Gestures reported by the touch controller hardware
+typedef enum {
+    UI_GESTURE_NONE,
+    UI_GESTURE_SWIPE_UP,
+    UI_GESTURE_SWIPE_DOWN,
+    UI_GESTURE_SWIPE_LEFT,
+    UI_GESTURE_SWIPE_RIGHT,
+    UI_GESTURE_LONG_PRESS
+} ui_gesture_t;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,14 +47,25 @@ extern "C" {
 // LVGL UI Initialization
 void lvgl_display_init();
 
-// Shot Stopper Screen Updates
+// Applies pending mailbox updates; called by the LVGL task with the LVGL lock held
+void lvgl_display_process_updates();
+
+// Shot Stopper Screen Updates (safe from any task)
 void update_display_value(int8_t weight);
 void show_verification_checkmark();
 void hide_verification_checkmark();
 void update_ble_status(ble_status_t status);
 void update_battery_status(uint8_t percentage);
+void update_battery_runtime(uint16_t minutes); // Appended to the battery label
+void update_power_profile_ui(bool low_power);  // Re-reads timeouts/brightness cap from power_profile
+
+// Live shot graph (safe from one producer task, e.g. MQTT); every sample is kept.
+// t_ms is when the sample was taken, on the millis() clock.
+void start_shot_graph();
+void add_shot_sample(float grams, uint32_t t_ms);
+void stop_shot_graph();
 
-// Home Assistant Screen Updates
+// Home Assistant Screen Updates (safe from any task)
 void update_ha_power_switch_ui(bool state);
 void update_ha_mode_ui(int8_t mode_index);
 void update_ha_temperature_ui(float temp);
@@ -49,13 +74,13 @@ void update_ha_preinfusion_time_ui(float time);
 void update_ha_last_shot_ui(float seconds);
 
 // Functions called by Encoder/Input handlers
-void ha_ui_handle_encoder_turn(int8_t direction);
 void ha_ui_reset_deselection_timer();
-void reset_inactivity_timer(); // New function for brightness
+void lvgl_display_handle_gesture(ui_gesture_t gesture, int32_t x, int32_t y); // LVGL task only
+void reset_inactivity_timer(); // New function for brightness (LVGL task only)
 
 // Expose screen pointers for encoder logic
 extern lv_obj_t* screen_shot_stopper;
-extern lv_obj_t* screen_ha;
+extern lv_obj_t* screen_ha; // NULL until the HA screen is first shown (and after teardown)
 
 
 #ifdef __cplusplus
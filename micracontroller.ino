@@ -20,6 +20,8 @@ void setup() {
 
 void loop() {
   // This function is required by the Arduino toolchain, but all work is
-  // handled by FreeRTOS tasks.
+  // handled by FreeRTOS tasks. It only polls for Serial debug commands.
+  app_poll_serial();
+  delay(100);
 }
 
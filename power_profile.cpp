@@ -0,0 +1,231 @@
+/*
+ * Power profile manager implementation.
+ *
+ * A FreeRTOS timer samples the battery monitor once a minute into a 30 minute
+ * history. The remaining runtime comes from the least-squares discharge slope
+ * over that window. The slope is scaled by the current load against the
+ * window's average load, so a screen that just woke up shows its own,
+ * shorter, runtime. Until the window is long enough, or while charging, the
+ * estimate falls back to the nominal capacity divided by the current load.
+ *
+ * The profile switch uses the runtime at the window's average load, not at
+ * the current one, so waking or blanking the screen can't flip it back and forth.
+ * The load model (battery_monitor.h calibration values) is the same one the
+ * battery monitor compensates the voltage sag with; every new estimate is passed on.
+ * Charging is detected as a rise above the lowest point of the window.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "power_profile.h"
+#include "battery_monitor.h"
+#include "lcd_bl_pwm_bsp.h"
+#include "ble_client.h"
+#include "lvgl_display.h"
+
+// --- Configuration ---
+#ifndef BATTERY_CAPACITY_MAH
+#define BATTERY_CAPACITY_MAH 1000 // Fitted cell; only used until a slope is measured
+#endif
+#define POWER_TICK_MS 60000               // History step and estimate refresh
+#define POWER_SETTLE_MS 1000              // Re-estimate this soon after a screen change
+#define POWER_HISTORY_LEN 31              // 30 minutes of one-minute points
+#define POWER_SLOPE_MIN_SPAN_MS (10 * 60 * 1000UL) // Shorter windows are mostly ADC noise
+#define POWER_SLOPE_MIN_DROP_PERMILLE 10  // Need at least 1 % of discharge to trust the slope
+#define POWER_CHARGE_RISE_PERMILLE 20     // A rise this large over the window's low means charging
+
+static const power_profile_t PROFILE_NORMAL = {
+    "normal",
+    30000,  // dim_timeout_ms
+    30000,  // off_timeout_ms
+    255,    // brightness_cap (the display's own high level applies)
+    0,      // ble_linger_ms: disconnect right after each read/write, as before profiles
+    15,     // mqtt_keepalive_s (ArduinoHA default)
+};
+
+static const power_profile_t PROFILE_LOW = {
+    "low-power",
+    10000,  // dim_timeout_ms
+    15000,  // off_timeout_ms
+    102,    // brightness_cap, ~40 %
+    0,      // ble_linger_ms: disconnect right after each read/write
+    120,    // mqtt_keepalive_s
+};
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t permille;
+    uint16_t load_ma;
+} power_point_t;
+
+static power_point_t history[POWER_HISTORY_LEN];
+static uint8_t history_head = 0;  // Next slot to write
+static uint8_t history_count = 0;
+
+static TimerHandle_t power_timer = NULL;
+static volatile power_screen_t screen_state = POWER_SCREEN_ON;
+static const power_profile_t* volatile current_profile = &PROFILE_NORMAL;
+
+static portMUX_TYPE status_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_status_t status = {POWER_RUNTIME_UNKNOWN, 0, false, false};
+static bool status_valid = false;
+
+// --- Estimation ---
+
+static uint16_t power_load_ma() {
+    uint32_t ma;
+    switch (screen_state) {
+        case POWER_SCREEN_AMBIENT: ma = BATTERY_LOAD_SCREEN_AMBIENT_MA; break;
+        case POWER_SCREEN_OFF: ma = BATTERY_LOAD_SCREEN_OFF_MA; break;
+        default: ma = BATTERY_LOAD_SCREEN_ON_MA; break;
+    }
+    ma += (uint32_t)BATTERY_LOAD_BACKLIGHT_MAX_MA * lcd_bl_get_duty() / 255;
+    if (WiFi.status() == WL_CONNECTED) ma += BATTERY_LOAD_WIFI_MA;
+    if (ble_client_session_open()) ma += BATTERY_LOAD_BLE_SESSION_MA;
+    return (uint16_t)ma;
+}
+
+static void history_add(uint32_t t_ms, uint16_t permille, uint16_t load_ma) {
+    history[history_head] = {t_ms, permille, load_ma};
+    history_head = (history_head + 1) % POWER_HISTORY_LEN;
+    if (history_count < POWER_HISTORY_LEN) history_count++;
+}
+
+static const power_point_t* history_at(uint8_t i) { // 0 = oldest
+    return &history[(history_head + POWER_HISTORY_LEN - history_count + i) % POWER_HISTORY_LEN];
+}
+
+// Lowest charge in the window; a clear rise above it means the cell is charging
+static uint16_t history_min_permille() {
+    uint16_t low = 1000;
+    for (uint8_t i = 0; i < history_count; i++) {
+        if (history_at(i)->permille < low) low = history_at(i)->permille;
+    }
+    return low;
+}
+
+// Discharge rate in permille per minute from a least-squares fit over the history,
+// or 0 if the window is too short or too flat to tell. Also returns the window's mean load.
+static float history_drain_rate(float* avg_load_ma) {
+    float sum_load = 0.0f;
+    for (uint8_t i = 0; i < history_count; i++) sum_load += history_at(i)->load_ma;
+    *avg_load_ma = history_count ? sum_load / history_count : 0.0f;
+
+    if (history_count < 3) return 0.0f;
+    const power_point_t* oldest = history_at(0);
+    const power_point_t* newest = history_at(history_count - 1);
+    if (newest->t_ms - oldest->t_ms < POWER_SLOPE_MIN_SPAN_MS) return 0.0f;
+    if (oldest->permille < newest->permille + POWER_SLOPE_MIN_DROP_PERMILLE) return 0.0f;
+
+    float mean_t = 0.0f, mean_p = 0.0f;
+    for (uint8_t i = 0; i < history_count; i++) {
+        mean_t += (history_at(i)->t_ms - oldest->t_ms) / 60000.0f;
+        mean_p += history_at(i)->permille;
+    }
+    mean_t /= history_count;
+    mean_p /= history_count;
+    float num = 0.0f, den = 0.0f;
+    for (uint8_t i = 0; i < history_count; i++) {
+        float dt = (history_at(i)->t_ms - oldest->t_ms) / 60000.0f - mean_t;
+        num += dt * (history_at(i)->permille - mean_p);
+        den += dt * dt;
+    }
+    float slope = den > 0.0f ? num / den : 0.0f;
+    return slope < 0.0f ? -slope : 0.0f;
+}
+
+// Minutes left at the given load
+static uint16_t runtime_at(uint16_t permille, float drain_rate, float avg_load_ma, uint16_t load_ma, bool* from_slope) {
+    float minutes;
+    *from_slope = drain_rate > 0.0f && avg_load_ma > 0.0f;
+    if (*from_slope) {
+        minutes = permille / drain_rate * (avg_load_ma / load_ma);
+    } else {
+        minutes = (permille / 1000.0f) * BATTERY_CAPACITY_MAH / load_ma * 60.0f;
+    }
+    return minutes >= POWER_RUNTIME_UNKNOWN - 1 ? POWER_RUNTIME_UNKNOWN - 1 : (uint16_t)minutes;
+}
+
+// --- Timer ---
+
+static void power_timer_cb(TimerHandle_t timer) {
+    battery_state_t battery;
+    if (!battery_monitor_get(&battery)) return; // Not sampled yet, retry at the short period
+
+    if (xTimerGetPeriod(timer) != pdMS_TO_TICKS(POWER_TICK_MS)) {
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(POWER_TICK_MS), 0); // Back to the regular step after a settle
+    }
+
+    uint32_t now = millis();
+    uint16_t permille = battery_permille_from_mv(battery.rest_mv);
+    uint16_t load_ma = power_load_ma();
+    battery_monitor_set_load_ma(load_ma); // Radios may have changed since the last screen change
+
+    if (history_count > 0 && permille > history_min_permille() + POWER_CHARGE_RISE_PERMILLE) {
+        history_count = 0; // Charging: the old slope no longer applies
+    }
+    if (history_count == 0 || now - history_at(history_count - 1)->t_ms >= POWER_TICK_MS - POWER_SETTLE_MS) {
+        history_add(now, permille, load_ma);
+    }
+
+    float avg_load_ma;
+    float drain_rate = history_drain_rate(&avg_load_ma);
+    bool from_slope, typical_from_slope;
+    uint16_t runtime = runtime_at(permille, drain_rate, avg_load_ma, load_ma, &from_slope);
+    uint16_t typical = runtime_at(permille, drain_rate, avg_load_ma, (uint16_t)(avg_load_ma + 0.5f), &typical_from_slope);
+
+    const power_profile_t* profile = current_profile;
+    if (profile == &PROFILE_NORMAL) {
+        if (battery.percent <= POWER_LOW_ENTER_PERCENT || typical <= POWER_LOW_ENTER_RUNTIME_MIN) profile = &PROFILE_LOW;
+    } else if (battery.percent >= POWER_LOW_ENTER_PERCENT + POWER_LOW_EXIT_MARGIN_PERCENT &&
+               typical >= 2 * POWER_LOW_ENTER_RUNTIME_MIN) {
+        profile = &PROFILE_NORMAL;
+    }
+    if (profile != current_profile) {
+        Serial.printf("[%lu] Power profile -> %s (%u%%, ~%u min at %u mA avg)\n", (unsigned long)now, profile->name,
+                      battery.percent, typical, (unsigned)(avg_load_ma + 0.5f));
+        current_profile = profile;
+        update_power_profile_ui(profile == &PROFILE_LOW);
+    }
+
+    bool runtime_changed;
+    taskENTER_CRITICAL(&status_lock);
+    runtime_changed = !status_valid || runtime != status.runtime_min;
+    status.runtime_min = runtime;
+    status.load_ma = load_ma;
+    status.from_slope = from_slope;
+    status.low_power = profile == &PROFILE_LOW;
+    status_valid = true;
+    taskEXIT_CRITICAL(&status_lock);
+
+    if (runtime_changed) update_battery_runtime(runtime);
+}
+
+// --- Public Functions ---
+
+void power_profile_init() {
+    battery_monitor_set_load_ma(power_load_ma());
+    // First estimate shortly after boot, once the battery monitor has a reading
+    power_timer = xTimerCreate("powerTimer", pdMS_TO_TICKS(POWER_SETTLE_MS * 2), pdTRUE, NULL, power_timer_cb);
+    if (power_timer == NULL || xTimerStart(power_timer, 0) != pdPASS) {
+        Serial.println("Failed to start the power profile timer!");
+    }
+}
+
+const power_profile_t* power_profile_current() { return current_profile; }
+
+bool power_profile_get_status(power_status_t* out) {
+    taskENTER_CRITICAL(&status_lock);
+    *out = status;
+    bool valid = status_valid;
+    taskEXIT_CRITICAL(&status_lock);
+    return valid;
+}
+
+void power_profile_set_screen(power_screen_t screen) {
+    if (screen == screen_state) return;
+    screen_state = screen;
+    battery_monitor_set_load_ma(power_load_ma()); // Compensate the next reading for the new load
+    // Re-estimate soon so the label shows the runtime for the new state
+    if (power_timer) xTimerChangePeriod(power_timer, pdMS_TO_TICKS(POWER_SETTLE_MS), 0);
+}
@@ -0,0 +1,68 @@
+/*
+ * Header for the power profile manager.
+ *
+ * Estimates the remaining runtime from the battery monitor and the current
+ * power state (screen on/dim/ambient/off, WiFi, BLE session), and switches
+ * the controller between a normal and a reduced-power profile when the
+ * battery runs low. The profile holds the settings other modules read:
+ * inactivity timeouts, brightness cap, BLE session linger and MQTT keepalive.
+ */
+#ifndef POWER_PROFILE_H
+#define POWER_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Enter the low-power profile at or below either threshold...
+#ifndef POWER_LOW_ENTER_PERCENT
+#define POWER_LOW_ENTER_PERCENT 20
+#endif
+#ifndef POWER_LOW_ENTER_RUNTIME_MIN
+#define POWER_LOW_ENTER_RUNTIME_MIN 60
+#endif
+// ...and leave it once the charge is this far above the entry level and the
+// runtime is at least twice the entry runtime (e.g. after charging)
+#ifndef POWER_LOW_EXIT_MARGIN_PERCENT
+#define POWER_LOW_EXIT_MARGIN_PERCENT 10
+#endif
+
+#define POWER_RUNTIME_UNKNOWN 0xFFFF
+
+// Screen states, reported by the display's inactivity logic
+typedef enum {
+    POWER_SCREEN_ON,
+    POWER_SCREEN_DIM,
+    POWER_SCREEN_AMBIENT,
+    POWER_SCREEN_OFF
+} power_screen_t;
+
+// Settings that differ between the normal and the low-power profile
+typedef struct {
+    const char* name;
+    uint32_t dim_timeout_ms;     // Inactivity before dimming
+    uint32_t off_timeout_ms;     // Further inactivity before ambient/off
+    uint8_t brightness_cap;      // Highest backlight duty (0-255)
+    uint32_t ble_linger_ms;      // Keep the BLE session open after a read/write (0 = disconnect at once)
+    uint16_t mqtt_keepalive_s;   // MQTT keepalive, applied on the next broker connect
+} power_profile_t;
+
+typedef struct {
+    uint16_t runtime_min;        // POWER_RUNTIME_UNKNOWN until the first battery reading
+    uint16_t load_ma;            // Load estimate for the current power state
+    bool from_slope;             // Runtime derived from the measured discharge slope
+    bool low_power;              // Low-power profile active
+} power_status_t;
+
+// Starts the estimator timer. Call after battery_monitor_init().
+void power_profile_init();
+
+// Active profile; the pointer stays valid, compare it to detect changes.
+const power_profile_t* power_profile_current();
+
+// Latest estimate. Returns false until the first battery reading is in.
+bool power_profile_get_status(power_status_t* out);
+
+// Called by the display when the screen changes state (any task).
+void power_profile_set_screen(power_screen_t screen);
+
+#endif // POWER_PROFILE_H
@@ -0,0 +1,193 @@
+/*
+ * On-device touch calibration.
+ *
+ * Shows a cross at three points on the round panel; each tap records where the
+ * (orientation-corrected, uncalibrated) touch landed. The affine map from the
+ * measured to the target points is solved exactly, sanity-checked and stored
+ * in NVS as six Q16 coefficients. touch_transform() applies it.
+ */
+#include "touch_calib.h"
+#include "lcd_bsp.h" // lcd_lvgl_wake()
+#include "ui_fonts.h"
+#include <lvgl.h>
+#include <atomic>
+#include <cmath>
+#include <Arduino.h>
+#include <Preferences.h>
+
+extern Preferences preferences;
+
+touch_calib_t touch_calibration = {false, 0, 0, 0, 0, 0, 0};
+
+#define CALIB_POINTS 3
+#define CALIB_CROSS_SIZE 24
+#define CALIB_MAX_SCALE_ERR 0.2f // Reject corrections outside 0.8..1.2 scale / 0.2 shear
+#define CALIB_MAX_OFFSET_PX 90
+
+// Inside the visible circle of the 360x360 round panel
+static const int32_t CALIB_TARGETS[CALIB_POINTS][2] = {{180, 60}, {60, 260}, {300, 260}};
+
+static std::atomic<bool> calib_requested(false);
+static std::atomic<bool> clear_requested(false);
+
+static lv_obj_t* calib_screen = NULL;
+static lv_obj_t* calib_cross_h = NULL;
+static lv_obj_t* calib_cross_v = NULL;
+static lv_obj_t* calib_label = NULL;
+static lv_obj_t* calib_return_screen = NULL;
+static lv_timer_t* calib_timeout = NULL;
+static touch_calib_t calib_backup;
+static int calib_index = 0;
+static int32_t calib_measured[CALIB_POINTS][2];
+
+void touch_calib_load(void) {
+    int32_t coeffs[6];
+    if (preferences.getBytes(TOUCH_CALIB_NVS_KEY, coeffs, sizeof(coeffs)) == sizeof(coeffs)) {
+        touch_calibration = {true, coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4], coeffs[5]};
+        Serial.printf("Touch calibration loaded: x' = %.3fx %+.3fy %+ld, y' = %.3fx %+.3fy %+ld\n",
+                      coeffs[0] / 65536.0f, coeffs[1] / 65536.0f, (long)coeffs[2],
+                      coeffs[3] / 65536.0f, coeffs[4] / 65536.0f, (long)coeffs[5]);
+    } else {
+        touch_calibration.valid = false;
+        Serial.println("No touch calibration stored, using orientation only.");
+    }
+}
+
+void touch_calib_request(void) {
+    calib_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+void touch_calib_request_clear(void) {
+    clear_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+static void show_target() {
+    int32_t x = CALIB_TARGETS[calib_index][0];
+    int32_t y = CALIB_TARGETS[calib_index][1];
+    lv_obj_set_pos(calib_cross_h, x - CALIB_CROSS_SIZE / 2, y - 1);
+    lv_obj_set_pos(calib_cross_v, x - 1, y - CALIB_CROSS_SIZE / 2);
+    lv_label_set_text_fmt(calib_label, "Tap the cross %d/%d", calib_index + 1, CALIB_POINTS);
+}
+
+static void finish(bool keep_backup) {
+    if (keep_backup) touch_calibration = calib_backup;
+    if (calib_timeout) {
+        lv_timer_del(calib_timeout);
+        calib_timeout = NULL;
+    }
+    lv_screen_load(calib_return_screen);
+    lv_obj_delete_async(calib_screen); // May be called from the screen's own event callback
+    calib_screen = NULL;
+}
+
+bool touch_calib_active(void) {
+    return calib_screen != NULL;
+}
+
+// Solves target = M * measured + t from the three samples and stores it if it looks sane
+static bool solve_and_store() {
+    const float mx0 = calib_measured[0][0], my0 = calib_measured[0][1];
+    const float mx1 = calib_measured[1][0], my1 = calib_measured[1][1];
+    const float mx2 = calib_measured[2][0], my2 = calib_measured[2][1];
+    const float det = (mx0 - mx2) * (my1 - my2) - (mx1 - mx2) * (my0 - my2);
+    if (fabsf(det) < 1000.0f) {
+        Serial.println("Touch calibration rejected: taps too close together.");
+        return false;
+    }
+    float coeffs[6];
+    for (int axis = 0; axis < 2; axis++) {
+        const float t0 = CALIB_TARGETS[0][axis], t1 = CALIB_TARGETS[1][axis], t2 = CALIB_TARGETS[2][axis];
+        float p = ((t0 - t2) * (my1 - my2) - (t1 - t2) * (my0 - my2)) / det;
+        float q = ((mx0 - mx2) * (t1 - t2) - (mx1 - mx2) * (t0 - t2)) / det;
+        coeffs[axis * 3 + 0] = p;
+        coeffs[axis * 3 + 1] = q;
+        coeffs[axis * 3 + 2] = t2 - p * mx2 - q * my2;
+    }
+    if (fabsf(coeffs[0] - 1.0f) > CALIB_MAX_SCALE_ERR || fabsf(coeffs[4] - 1.0f) > CALIB_MAX_SCALE_ERR ||
+        fabsf(coeffs[1]) > CALIB_MAX_SCALE_ERR || fabsf(coeffs[3]) > CALIB_MAX_SCALE_ERR ||
+        fabsf(coeffs[2]) > CALIB_MAX_OFFSET_PX || fabsf(coeffs[5]) > CALIB_MAX_OFFSET_PX) {
+        Serial.printf("Touch calibration rejected: x' = %.3fx %+.3fy %+.1f, y' = %.3fx %+.3fy %+.1f "
+                      "(check EXAMPLE_TOUCH_ROTATION/MIRROR first)\n",
+                      coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4], coeffs[5]);
+        return false;
+    }
+
+    int32_t fixed[6];
+    for (int i = 0; i < 6; i++) {
+        bool offset = (i % 3) == 2;
+        fixed[i] = (int32_t)lroundf(offset ? coeffs[i] : coeffs[i] * (1 << TOUCH_CALIB_FRAC_BITS));
+    }
+    preferences.putBytes(TOUCH_CALIB_NVS_KEY, fixed, sizeof(fixed));
+    touch_calibration = {true, fixed[0], fixed[1], fixed[2], fixed[3], fixed[4], fixed[5]};
+    Serial.printf("Touch calibration stored: x' = %.3fx %+.3fy %+.1f, y' = %.3fx %+.3fy %+.1f\n",
+                  coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4], coeffs[5]);
+    return true;
+}
+
+static void calib_released_cb(lv_event_t* e) {
+    lv_point_t p;
+    lv_indev_get_point(lv_indev_active(), &p);
+    calib_measured[calib_index][0] = p.x;
+    calib_measured[calib_index][1] = p.y;
+    Serial.printf("Calibration point %d: target (%ld, %ld), touched (%ld, %ld)\n", calib_index + 1,
+                  (long)CALIB_TARGETS[calib_index][0], (long)CALIB_TARGETS[calib_index][1], (long)p.x, (long)p.y);
+    lv_timer_reset(calib_timeout);
+
+    if (++calib_index < CALIB_POINTS) {
+        show_target();
+        return;
+    }
+    finish(!solve_and_store());
+}
+
+static void calib_timeout_cb(lv_timer_t* timer) {
+    Serial.println("Touch calibration timed out, keeping the previous correction.");
+    finish(true);
+}
+
+static void start() {
+    if (calib_screen) return; // Already running
+    calib_backup = touch_calibration;
+    touch_calibration.valid = false; // Measure without the old correction
+    calib_index = 0;
+    calib_return_screen = lv_scr_act();
+
+    calib_screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(calib_screen, lv_color_black(), 0);
+    lv_obj_clear_flag(calib_screen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(calib_screen, calib_released_cb, LV_EVENT_RELEASED, NULL);
+
+    calib_cross_h = lv_obj_create(calib_screen);
+    calib_cross_v = lv_obj_create(calib_screen);
+    lv_obj_t* bars[] = {calib_cross_h, calib_cross_v};
+    for (lv_obj_t* bar : bars) {
+        lv_obj_remove_style_all(bar);
+        lv_obj_set_style_bg_color(bar, lv_color_white(), 0);
+        lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, 0);
+        lv_obj_clear_flag(bar, LV_OBJ_FLAG_CLICKABLE);
+    }
+    lv_obj_set_size(calib_cross_h, CALIB_CROSS_SIZE, 3);
+    lv_obj_set_size(calib_cross_v, 3, CALIB_CROSS_SIZE);
+
+    calib_label = lv_label_create(calib_screen);
+    lv_obj_set_style_text_font(calib_label, ui_font_small, 0);
+    lv_obj_set_style_text_color(calib_label, lv_color_white(), 0);
+    lv_obj_align(calib_label, LV_ALIGN_CENTER, 0, 0);
+
+    show_target();
+    lv_screen_load(calib_screen);
+    calib_timeout = lv_timer_create(calib_timeout_cb, TOUCH_CALIB_TIMEOUT_MS, NULL);
+    Serial.println("Touch calibration started.");
+}
+
+void touch_calib_poll(void) {
+    if (clear_requested.exchange(false)) {
+        preferences.remove(TOUCH_CALIB_NVS_KEY);
+        touch_calibration.valid = false;
+        if (calib_screen) calib_backup.valid = false;
+        Serial.println("Touch calibration cleared.");
+    }
+    if (calib_requested.exchange(false)) start();
+}
@@ -0,0 +1,102 @@
+/*
+ * Touch calibration for the CST816.
+ *
+ * One stage maps raw controller coordinates to screen pixels. The orientation
+ * (EXAMPLE_TOUCH_ROTATION / EXAMPLE_TOUCH_MIRROR_X / EXAMPLE_TOUCH_MIRROR_Y in
+ * lcd_config.h) is resolved by the preprocessor, so the common orientations
+ * compile down to constant adds and subtracts. An optional affine correction,
+ * measured on the device with touch_calib_request(), is stored in NVS and
+ * applied after it in Q16 fixed point.
+ */
+#ifndef TOUCH_CALIB_H
+#define TOUCH_CALIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_config.h"
+
+#define TOUCH_CALIB_NVS_KEY "tcal"
+#define TOUCH_CALIB_FRAC_BITS 16
+#define TOUCH_CALIB_TIMEOUT_MS 15000 // Abort the calibration screen if no tap arrives in time
+
+typedef struct {
+    bool valid;
+    int32_t a, b, c; // x' = ((a * x + b * y) >> 16) + c
+    int32_t d, e, f; // y' = ((d * x + e * y) >> 16) + f
+} touch_calib_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern touch_calib_t touch_calibration;
+
+// Raw CST816 point -> screen point, clamped to the panel
+static inline void touch_transform(int32_t raw_x, int32_t raw_y, int32_t *out_x, int32_t *out_y) {
+#if EXAMPLE_TOUCH_ROTATION == 90
+    int32_t x = (EXAMPLE_LCD_V_RES - 1) - raw_y;
+    int32_t y = raw_x;
+#elif EXAMPLE_TOUCH_ROTATION == 180
+    int32_t x = (EXAMPLE_LCD_H_RES - 1) - raw_x;
+    int32_t y = (EXAMPLE_LCD_V_RES - 1) - raw_y;
+#elif EXAMPLE_TOUCH_ROTATION == 270
+    int32_t x = raw_y;
+    int32_t y = (EXAMPLE_LCD_H_RES - 1) - raw_x;
+#else
+    int32_t x = raw_x;
+    int32_t y = raw_y;
+#endif
+#if EXAMPLE_TOUCH_MIRROR_X
+    x = (EXAMPLE_LCD_H_RES - 1) - x;
+#endif
+#if EXAMPLE_TOUCH_MIRROR_Y
+    y = (EXAMPLE_LCD_V_RES - 1) - y;
+#endif
+    if (touch_calibration.valid) {
+        const int32_t half = 1 << (TOUCH_CALIB_FRAC_BITS - 1);
+        int32_t cx = ((touch_calibration.a * x + touch_calibration.b * y + half) >> TOUCH_CALIB_FRAC_BITS) + touch_calibration.c;
+        int32_t cy = ((touch_calibration.d * x + touch_calibration.e * y + half) >> TOUCH_CALIB_FRAC_BITS) + touch_calibration.f;
+        x = cx;
+        y = cy;
+    }
+    *out_x = x < 0 ? 0 : (x >= EXAMPLE_LCD_H_RES ? EXAMPLE_LCD_H_RES - 1 : x);
+    *out_y = y < 0 ? 0 : (y >= EXAMPLE_LCD_V_RES ? EXAMPLE_LCD_V_RES - 1 : y);
+}
+
+// Rotates/mirrors a swipe direction given as a unit step (dx, dy) the same way as points
+static inline void touch_transform_dir(int8_t *dx, int8_t *dy) {
+#if EXAMPLE_TOUCH_ROTATION == 90
+    int8_t x = -*dy, y = *dx;
+#elif EXAMPLE_TOUCH_ROTATION == 180
+    int8_t x = -*dx, y = -*dy;
+#elif EXAMPLE_TOUCH_ROTATION == 270
+    int8_t x = *dy, y = -*dx;
+#else
+    int8_t x = *dx, y = *dy;
+#endif
+#if EXAMPLE_TOUCH_MIRROR_X
+    x = -x;
+#endif
+#if EXAMPLE_TOUCH_MIRROR_Y
+    y = -y;
+#endif
+    *dx = x;
+    *dy = y;
+}
+
+// Loads the stored correction. Call once Preferences is open.
+void touch_calib_load(void);
+
+// Safe from any task; handled by touch_calib_poll() on the LVGL task
+void touch_calib_request(void); // Show the 3-point calibration screen
+void touch_calib_request_clear(void); // Drop the stored correction
+
+// LVGL task only (lock held)
+void touch_calib_poll(void);
+bool touch_calib_active(void); // Calibration screen is showing; gestures must not navigate away
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_CALIB_H
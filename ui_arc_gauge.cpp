@@ -0,0 +1,203 @@
+/*
+ * Edge arc gauge implementation.
+ *
+ * Mask precomputation: every pixel near the ring is assigned to the segment
+ * containing its centre's angle, and its coverage is the fraction of a 4x4
+ * subpixel grid that falls between the inner and outer radius. Each pixel
+ * belongs to exactly one segment, so adjacent segments tile the ring
+ * without seams; the radial edges are anti-aliased and the fill end is
+ * pixel-exact at one-degree resolution.
+ *
+ * Invalidation: the segments between the old and new fill are grouped into
+ * at most UI_ARC_GAUGE_MAX_AREAS bounding boxes, keeping LVGL's invalid
+ * area list from overflowing into a full-screen refresh on large jumps.
+ */
+
+#include "ui_arc_gauge.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <math.h>
+#include <string.h>
+
+#define UI_ARC_GAUGE_SUBSAMPLES 4   // Per axis, for the radial anti-aliasing
+#define UI_ARC_GAUGE_MAX_AREAS 8    // Invalid areas per value change
+
+// Segment index of the pixel centred at (x + 0.5, y + 0.5), -1 if outside the sweep
+static int32_t pixel_segment(float cx, float cy, int32_t x, int32_t y, uint16_t start_deg, uint16_t sweep_deg) {
+    float deg = atan2f(y + 0.5f - cy, x + 0.5f - cx) * (180.0f / (float)M_PI);
+    float rel = fmodf(deg - start_deg + 720.0f, 360.0f);
+    if (rel >= sweep_deg) return -1;
+    return (int32_t)rel;
+}
+
+static uint8_t pixel_coverage(float cx, float cy, int32_t x, int32_t y, float r_in, float r_out) {
+    const int n = UI_ARC_GAUGE_SUBSAMPLES;
+    int inside = 0;
+    for (int sy = 0; sy < n; sy++) {
+        float dy = y + (sy + 0.5f) / n - cy;
+        for (int sx = 0; sx < n; sx++) {
+            float dx = x + (sx + 0.5f) / n - cx;
+            float r = sqrtf(dx * dx + dy * dy);
+            if (r >= r_in && r <= r_out) inside++;
+        }
+    }
+    return (uint8_t)((inside * 255 + (n * n) / 2) / (n * n));
+}
+
+static void draw_cb(lv_event_t* e) {
+    ui_arc_gauge_t* gauge = (ui_arc_gauge_t*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+    lv_area_t coords;
+    lv_obj_get_coords(gauge->obj, &coords);
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.recolor_opa = LV_OPA_COVER; // A8 masks are drawn in the recolor color
+
+    for (uint16_t i = 0; i < gauge->segment_count; i++) {
+        const ui_arc_segment_t* seg = &gauge->segments[i];
+        lv_area_t area = seg->area;
+        lv_area_move(&area, coords.x1, coords.y1);
+        if (!lv_area_is_on(&area, &layer->_clip_area)) continue;
+        dsc.src = &seg->mask;
+        dsc.recolor = (i < gauge->active) ? gauge->active_color : gauge->track_color;
+        lv_draw_image(layer, &dsc, &area);
+    }
+}
+
+// Invalidates segments [from, to) in at most UI_ARC_GAUGE_MAX_AREAS groups
+static void invalidate_segments(ui_arc_gauge_t* gauge, uint16_t from, uint16_t to) {
+    lv_area_t coords;
+    lv_obj_get_coords(gauge->obj, &coords);
+    uint16_t count = to - from;
+    uint16_t group = (count + UI_ARC_GAUGE_MAX_AREAS - 1) / UI_ARC_GAUGE_MAX_AREAS;
+    for (uint16_t first = from; first < to; first += group) {
+        uint16_t last = (first + group < to) ? first + group : to;
+        lv_area_t area = gauge->segments[first].area;
+        for (uint16_t i = first + 1; i < last; i++) {
+            const lv_area_t* a = &gauge->segments[i].area;
+            area.x1 = LV_MIN(area.x1, a->x1);
+            area.y1 = LV_MIN(area.y1, a->y1);
+            area.x2 = LV_MAX(area.x2, a->x2);
+            area.y2 = LV_MAX(area.y2, a->y2);
+        }
+        lv_area_move(&area, coords.x1, coords.y1);
+        lv_obj_invalidate_area(gauge->obj, &area);
+        gauge->invalidations++;
+    }
+    gauge->segments_invalidated += count;
+}
+
+bool ui_arc_gauge_create(ui_arc_gauge_t* gauge, lv_obj_t* parent, int32_t size, int32_t thickness,
+                         uint16_t start_deg, uint16_t sweep_deg, lv_color_t track_color,
+                         lv_color_t active_color) {
+    memset(gauge, 0, sizeof(*gauge));
+    gauge->segment_count = sweep_deg;
+    gauge->range_max = 100;
+    gauge->track_color = track_color;
+    gauge->active_color = active_color;
+    uint32_t start_ms = millis();
+
+    const float cx = size / 2.0f;
+    const float cy = size / 2.0f;
+    const float r_out = size / 2.0f - 1.0f; // Keep the anti-aliased edge inside the object
+    const float r_in = r_out - thickness;
+
+    gauge->segments = (ui_arc_segment_t*)heap_caps_malloc(sweep_deg * sizeof(ui_arc_segment_t), MALLOC_CAP_8BIT);
+    if (!gauge->segments) return false;
+    for (uint16_t i = 0; i < sweep_deg; i++) {
+        gauge->segments[i].area = {INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN};
+    }
+
+    // Pass 1: bounding box of each segment (only pixels that touch the ring)
+    for (int32_t y = 0; y < size; y++) {
+        for (int32_t x = 0; x < size; x++) {
+            float dx = x + 0.5f - cx, dy = y + 0.5f - cy;
+            float r = sqrtf(dx * dx + dy * dy);
+            if (r < r_in - 1.0f || r > r_out + 1.0f) continue;
+            int32_t s = pixel_segment(cx, cy, x, y, start_deg, sweep_deg);
+            if (s < 0) continue;
+            lv_area_t* a = &gauge->segments[s].area;
+            a->x1 = LV_MIN(a->x1, x);
+            a->y1 = LV_MIN(a->y1, y);
+            a->x2 = LV_MAX(a->x2, x);
+            a->y2 = LV_MAX(a->y2, y);
+        }
+    }
+
+    size_t total = 0;
+    for (uint16_t i = 0; i < sweep_deg; i++) {
+        lv_area_t* a = &gauge->segments[i].area;
+        if (a->x1 > a->x2) *a = {0, 0, 0, 0}; // Degenerate (tiny ring): a single empty pixel
+        total += lv_area_get_size(a);
+    }
+    // Internal RAM keeps the per-frame blits fast; fall back to PSRAM
+    gauge->mask_data = (uint8_t*)heap_caps_calloc(1, total, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!gauge->mask_data) gauge->mask_data = (uint8_t*)heap_caps_calloc(1, total, MALLOC_CAP_SPIRAM);
+    if (!gauge->mask_data) {
+        heap_caps_free(gauge->segments);
+        gauge->segments = NULL;
+        return false;
+    }
+
+    // Pass 2: fill each segment's coverage mask
+    uint8_t* next = gauge->mask_data;
+    for (uint16_t i = 0; i < sweep_deg; i++) {
+        ui_arc_segment_t* seg = &gauge->segments[i];
+        int32_t w = lv_area_get_width(&seg->area);
+        int32_t h = lv_area_get_height(&seg->area);
+        for (int32_t y = seg->area.y1; y <= seg->area.y2; y++) {
+            for (int32_t x = seg->area.x1; x <= seg->area.x2; x++) {
+                if (pixel_segment(cx, cy, x, y, start_deg, sweep_deg) != i) continue;
+                next[(y - seg->area.y1) * w + (x - seg->area.x1)] = pixel_coverage(cx, cy, x, y, r_in, r_out);
+            }
+        }
+        seg->mask.header.magic = LV_IMAGE_HEADER_MAGIC;
+        seg->mask.header.cf = LV_COLOR_FORMAT_A8;
+        seg->mask.header.w = w;
+        seg->mask.header.h = h;
+        seg->mask.header.stride = w;
+        seg->mask.data_size = w * h;
+        seg->mask.data = next;
+        next += w * h;
+    }
+
+    gauge->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(gauge->obj);
+    lv_obj_set_size(gauge->obj, size, size);
+    lv_obj_clear_flag(gauge->obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(gauge->obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(gauge->obj, draw_cb, LV_EVENT_DRAW_MAIN, gauge);
+
+    Serial.printf("Arc gauge: %u segments, %u bytes of masks, built in %lu ms\n",
+                  (unsigned)sweep_deg, (unsigned)total, millis() - start_ms);
+    return true;
+}
+
+static uint16_t value_to_segments(const ui_arc_gauge_t* gauge, int32_t value) {
+    int32_t span = gauge->range_max - gauge->range_min;
+    return (uint16_t)(((value - gauge->range_min) * gauge->segment_count + span / 2) / span);
+}
+
+void ui_arc_gauge_set_range(ui_arc_gauge_t* gauge, int32_t min, int32_t max) {
+    if (max <= min) return;
+    gauge->range_min = min;
+    gauge->range_max = max;
+    gauge->value = LV_CLAMP(min, gauge->value, max);
+    gauge->active = value_to_segments(gauge, gauge->value);
+    if (gauge->obj) lv_obj_invalidate(gauge->obj);
+}
+
+bool ui_arc_gauge_set_value(ui_arc_gauge_t* gauge, int32_t value) {
+    if (!gauge->obj) return false;
+    value = LV_CLAMP(gauge->range_min, value, gauge->range_max);
+    gauge->value = value;
+    uint16_t active = value_to_segments(gauge, value);
+    if (active == gauge->active) return false;
+
+    uint16_t from = LV_MIN(active, gauge->active);
+    uint16_t to = LV_MAX(active, gauge->active);
+    gauge->active = active;
+    invalidate_segments(gauge, from, to);
+    return true;
+}
@@ -0,0 +1,59 @@
+/*
+ * Header for the edge arc gauge widget.
+ *
+ * A ring around the edge of the round panel that fills from the start angle
+ * in proportion to a value within a configurable range. The ring is cut into
+ * one-degree segments whose anti-aliased coverage masks are computed once at
+ * creation; drawing is just blitting those A8 masks in the track or active
+ * color, and a value change invalidates only the segments between the old
+ * and new fill angle.
+ */
+#ifndef UI_ARC_GAUGE_H
+#define UI_ARC_GAUGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+typedef struct {
+    lv_area_t area;                 // Bounding box relative to the gauge object
+    lv_image_dsc_t mask;            // A8 coverage, only this segment's pixels are non-zero
+} ui_arc_segment_t;
+
+typedef struct {
+    lv_obj_t* obj;                  // Square object the ring is inscribed in
+    ui_arc_segment_t* segments;     // One per degree of sweep
+    uint8_t* mask_data;             // Backing store for all segment masks
+    uint16_t segment_count;
+    uint16_t active;                // Segments currently drawn in the active color
+    int32_t range_min;
+    int32_t range_max;
+    int32_t value;                  // Last value set (clamped)
+    lv_color_t track_color;
+    lv_color_t active_color;
+    uint32_t invalidations;         // Stats: areas invalidated by value changes
+    uint32_t segments_invalidated;  // Stats: segments covered by those areas
+} ui_arc_gauge_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates a size x size gauge under parent and precomputes the segment masks.
+// start_deg is measured clockwise from 3 o'clock; the ring is thickness px wide
+// at the object's edge. Returns false if the mask memory could not be allocated.
+bool ui_arc_gauge_create(ui_arc_gauge_t* gauge, lv_obj_t* parent, int32_t size, int32_t thickness,
+                         uint16_t start_deg, uint16_t sweep_deg, lv_color_t track_color,
+                         lv_color_t active_color);
+
+// Sets the value range mapped onto the sweep. Redraws the whole ring.
+void ui_arc_gauge_set_range(ui_arc_gauge_t* gauge, int32_t min, int32_t max);
+
+// Sets the value (clamped to the range). Returns true if the fill changed.
+bool ui_arc_gauge_set_value(ui_arc_gauge_t* gauge, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_ARC_GAUGE_H
@@ -0,0 +1,117 @@
+/*
+ * Label binding layer implementation.
+ *
+ * All functions run in the LVGL task (they are called from the mailbox
+ * apply functions), so the cache and counters need no synchronisation.
+ */
+
+#include "ui_binding.h"
+#include <lvgl.h>
+
+#define UI_BINDING_TEXT_MAX 32
+
+static uint32_t stat_applied = 0;
+static uint32_t stat_skipped = 0;
+
+static const int32_t POW10[] = {1, 10, 100, 1000, 10000};
+
+size_t ui_format_fixed(char* buf, size_t buf_len, int32_t value, uint8_t decimals) {
+    if (buf == NULL || buf_len == 0) return 0;
+
+    char digits[16];
+    size_t n = 0;
+    bool negative = value < 0;
+    uint32_t v = negative ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+
+    // Build the string backwards: fraction digits, point, integer digits, sign
+    for (uint8_t d = 0; d < decimals && n < sizeof(digits); d++) {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    }
+    if (decimals > 0 && n < sizeof(digits)) digits[n++] = '.';
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0 && n < sizeof(digits));
+    if (negative && n < sizeof(digits)) digits[n++] = '-';
+
+    size_t out = 0;
+    while (n > 0 && out + 1 < buf_len) {
+        buf[out++] = digits[--n];
+    }
+    buf[out] = '\0';
+    return out;
+}
+
+int32_t ui_float_to_fixed(float value, uint8_t decimals) {
+    float scaled = value * (float)POW10[decimals < 4 ? decimals : 4];
+    return (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+static size_t append(char* buf, size_t pos, const char* text) {
+    if (text == NULL) return pos;
+    while (*text && pos + 1 < UI_BINDING_TEXT_MAX) {
+        buf[pos++] = *text++;
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+void ui_binding_init(ui_label_binding_t* binding, lv_obj_t* label, const char* prefix, const char* suffix, uint8_t decimals) {
+    binding->label = label;
+    binding->prefix = prefix;
+    binding->suffix = suffix;
+    binding->decimals = decimals < 4 ? decimals : 4;
+    binding->has_value = false;
+    binding->last_value = 0;
+}
+
+void ui_binding_unbind(ui_label_binding_t* binding) {
+    binding->label = NULL;
+    binding->has_value = false;
+}
+
+bool ui_binding_set_fixed(ui_label_binding_t* binding, int32_t value) {
+    if (binding->label == NULL) return false;
+    if (binding->has_value && binding->last_value == value) {
+        stat_skipped++;
+        return false;
+    }
+
+    char text[UI_BINDING_TEXT_MAX];
+    size_t pos = append(text, 0, binding->prefix);
+    pos += ui_format_fixed(text + pos, sizeof(text) - pos, value, binding->decimals);
+    append(text, pos, binding->suffix);
+
+    lv_label_set_text(binding->label, text);
+    binding->last_value = value;
+    binding->has_value = true;
+    stat_applied++;
+    return true;
+}
+
+bool ui_binding_set_float(ui_label_binding_t* binding, float value) {
+    return ui_binding_set_fixed(binding, ui_float_to_fixed(value, binding->decimals));
+}
+
+bool ui_binding_set_text(ui_label_binding_t* binding, int32_t key, const char* text) {
+    if (binding->label == NULL) return false;
+    if (binding->has_value && binding->last_value == key) {
+        stat_skipped++;
+        return false;
+    }
+    lv_label_set_text_static(binding->label, text);
+    binding->last_value = key;
+    binding->has_value = true;
+    stat_applied++;
+    return true;
+}
+
+void ui_binding_mark_stale(ui_label_binding_t* binding) {
+    binding->has_value = false;
+}
+
+void ui_binding_get_stats(uint32_t* applied, uint32_t* skipped) {
+    if (applied) *applied = stat_applied;
+    if (skipped) *skipped = stat_skipped;
+}
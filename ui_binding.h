@@ -0,0 +1,66 @@
+/*
+ * Header for the label binding layer.
+ *
+ * A binding ties an LVGL label to a fixed-point value. The label is only
+ * rewritten (and therefore only invalidated/redrawn) when the value actually
+ * changes, and the text is produced by a small integer formatter instead of
+ * vsnprintf with %f.
+ */
+#ifndef UI_BINDING_H
+#define UI_BINDING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Forward declare lv_obj_t type instead of including the full header
+struct _lv_obj_t;
+typedef struct _lv_obj_t lv_obj_t;
+
+typedef struct {
+    lv_obj_t* label;        // Bound label, NULL while the widget doesn't exist
+    const char* prefix;     // Text before the number (may be NULL)
+    const char* suffix;     // Text after the number (may be NULL)
+    uint8_t decimals;       // Value is stored in units of 10^-decimals
+    bool has_value;         // False until the first value is rendered
+    int32_t last_value;     // Last rendered fixed-point value (or text key)
+} ui_label_binding_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// (Re)binds a label. Clears the cache so the next set always renders.
+void ui_binding_init(ui_label_binding_t* binding, lv_obj_t* label, const char* prefix, const char* suffix, uint8_t decimals);
+
+// Detaches the label (e.g. before it is deleted); later sets are no-ops until rebound.
+void ui_binding_unbind(ui_label_binding_t* binding);
+
+// Renders prefix + value + suffix if the value differs from the last one.
+// Returns true if the label was updated.
+bool ui_binding_set_fixed(ui_label_binding_t* binding, int32_t value);
+
+// Same as ui_binding_set_fixed() but takes a float and rounds it to the binding's precision.
+bool ui_binding_set_float(ui_label_binding_t* binding, float value);
+
+// For labels that show one of a set of strings: key identifies the text.
+bool ui_binding_set_text(ui_label_binding_t* binding, int32_t key, const char* text);
+
+// Forces the next set to render, e.g. after prefix/suffix were changed.
+void ui_binding_mark_stale(ui_label_binding_t* binding);
+
+// Formats a fixed-point integer (e.g. 935 with 1 decimal -> "93.5").
+// Returns the number of characters written, excluding the terminator.
+size_t ui_format_fixed(char* buf, size_t buf_len, int32_t value, uint8_t decimals);
+
+// Converts a float to fixed point with round-half-away-from-zero.
+int32_t ui_float_to_fixed(float value, uint8_t decimals);
+
+// Number of set calls that changed a label vs. were skipped as unchanged
+void ui_binding_get_stats(uint32_t* applied, uint32_t* skipped);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_BINDING_H
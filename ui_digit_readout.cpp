@@ -0,0 +1,136 @@
+/*
+ * Numeric readout widget implementation.
+ *
+ * Cells are laid out right-aligned inside a fixed-width root so the digits
+ * never move when a single digit changes. When the number of digits changes
+ * (e.g. 99 -> 100) the root is shifted to keep the text centred; that one
+ * update redraws the whole readout, which is rare.
+ */
+
+#include "ui_digit_readout.h"
+#include "ui_binding.h" // ui_format_fixed()
+#include <string.h>
+
+#define UI_READOUT_UNIT_GAP 8 // Pixels between the last digit and the unit
+
+static void roll_anim_cb(void* obj, int32_t v) {
+    lv_obj_set_style_translate_y((lv_obj_t*)obj, v, 0);
+}
+
+// Horizontal offset that centres the visible cells + unit on the root's alignment point
+static int32_t centring_offset(const ui_digit_readout_t* readout) {
+    return -((int32_t)(UI_READOUT_MAX_CELLS - readout->visible_cells) * readout->cell_w) / 2;
+}
+
+void ui_digit_readout_create(ui_digit_readout_t* readout, lv_obj_t* parent, const lv_font_t* font,
+                             lv_color_t color, const char* unit, uint32_t anim_ms) {
+    memset(readout, 0, sizeof(*readout));
+    readout->anim_ms = anim_ms;
+
+    // Fixed cell size: widest digit of the font, so every digit fits every cell
+    int32_t widest = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        int32_t w = lv_font_get_glyph_width(font, (uint32_t)c, 0);
+        if (w > widest) widest = w;
+    }
+    readout->cell_w = widest;
+    readout->cell_h = lv_font_get_line_height(font);
+
+    readout->root = lv_obj_create(parent);
+    lv_obj_remove_style_all(readout->root);
+    lv_obj_clear_flag(readout->root, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(readout->root, LV_OBJ_FLAG_CLICKABLE);
+
+    for (int i = 0; i < UI_READOUT_MAX_CELLS; i++) {
+        lv_obj_t* cell = lv_obj_create(readout->root);
+        lv_obj_remove_style_all(cell); // Transparent, children are clipped to the cell
+        lv_obj_clear_flag(cell, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_clear_flag(cell, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_size(cell, readout->cell_w, readout->cell_h);
+        lv_obj_set_pos(cell, i * readout->cell_w, 0);
+
+        lv_obj_t* glyph = lv_label_create(cell);
+        lv_obj_set_style_text_font(glyph, font, 0);
+        lv_obj_set_style_text_color(glyph, color, 0);
+        lv_label_set_text_static(glyph, "");
+        lv_obj_center(glyph);
+
+        readout->cells[i] = cell;
+        readout->glyphs[i] = glyph;
+        readout->shown[i] = ' ';
+    }
+    readout->shown[UI_READOUT_MAX_CELLS] = '\0';
+
+    int32_t width = UI_READOUT_MAX_CELLS * readout->cell_w;
+    if (unit) {
+        readout->unit = lv_label_create(readout->root);
+        lv_obj_set_style_text_font(readout->unit, font, 0);
+        lv_obj_set_style_text_color(readout->unit, color, 0);
+        lv_label_set_text_static(readout->unit, unit);
+        lv_obj_set_pos(readout->unit, width + UI_READOUT_UNIT_GAP, 0);
+        width += UI_READOUT_UNIT_GAP + lv_text_get_width(unit, strlen(unit), font, 0);
+    }
+    lv_obj_set_size(readout->root, width, readout->cell_h);
+}
+
+bool ui_digit_readout_set_text(ui_digit_readout_t* readout, const char* text) {
+    size_t len = strlen(text);
+    if (len > UI_READOUT_MAX_CELLS) len = UI_READOUT_MAX_CELLS;
+
+    // Right-align into the cell row, blanks on the left
+    char next[UI_READOUT_MAX_CELLS + 1];
+    memset(next, ' ', UI_READOUT_MAX_CELLS);
+    memcpy(next + (UI_READOUT_MAX_CELLS - len), text, len);
+    next[UI_READOUT_MAX_CELLS] = '\0';
+
+    if ((uint8_t)len != readout->visible_cells) {
+        readout->visible_cells = (uint8_t)len;
+        // Keep the text centred on the point the caller aligned the root to
+        lv_obj_set_style_translate_x(readout->root, centring_offset(readout), 0);
+    }
+
+    bool changed = false;
+    for (int i = 0; i < UI_READOUT_MAX_CELLS; i++) {
+        if (next[i] == readout->shown[i]) {
+            readout->cells_skipped++;
+            continue;
+        }
+        readout->shown[i] = next[i];
+        char glyph_text[2] = {next[i] == ' ' ? '\0' : next[i], '\0'};
+        lv_label_set_text(readout->glyphs[i], glyph_text); // Invalidates this cell only
+        readout->cells_updated++;
+        changed = true;
+    }
+    return changed;
+}
+
+bool ui_digit_readout_set_value(ui_digit_readout_t* readout, int32_t value) {
+    char text[12];
+    ui_format_fixed(text, sizeof(text), value, 0);
+
+    char before[UI_READOUT_MAX_CELLS + 1];
+    memcpy(before, readout->shown, sizeof(before));
+    bool rolling_up = readout->has_value && value > readout->value;
+    bool animate = readout->anim_ms > 0 && readout->has_value && value != readout->value;
+
+    bool changed = ui_digit_readout_set_text(readout, text);
+    readout->value = value;
+    readout->has_value = true;
+
+    if (changed && animate) {
+        for (int i = 0; i < UI_READOUT_MAX_CELLS; i++) {
+            if (readout->shown[i] == before[i] || readout->shown[i] == ' ') continue;
+            // New digit slides in from below when counting up, from above when counting down.
+            // The cell clips its child, so the animation only invalidates this cell.
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_var(&a, readout->glyphs[i]);
+            lv_anim_set_exec_cb(&a, roll_anim_cb);
+            lv_anim_set_values(&a, rolling_up ? readout->cell_h : -readout->cell_h, 0);
+            lv_anim_set_duration(&a, readout->anim_ms);
+            lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+            lv_anim_start(&a);
+        }
+    }
+    return changed;
+}
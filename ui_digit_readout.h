@@ -0,0 +1,53 @@
+/*
+ * Header for the numeric readout widget.
+ *
+ * Shows a short number plus a unit (e.g. "36 g") with every character in its
+ * own fixed-size cell. Updating the value only touches the cells whose
+ * character changed, so a knob tick from 36 to 37 redraws and flushes one
+ * digit instead of the whole large-font text box. An optional rolling
+ * animation is confined to the changed cells as well.
+ */
+#ifndef UI_DIGIT_READOUT_H
+#define UI_DIGIT_READOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#define UI_READOUT_MAX_CELLS 4 // Enough for an int8_t weight ("-128")
+
+typedef struct {
+    lv_obj_t* root;                             // Transparent container, align this like a label
+    lv_obj_t* cells[UI_READOUT_MAX_CELLS];      // Clipping cell per character
+    lv_obj_t* glyphs[UI_READOUT_MAX_CELLS];     // One-character label inside each cell
+    lv_obj_t* unit;                             // Unit label after the digits (may be NULL)
+    char shown[UI_READOUT_MAX_CELLS + 1];       // Characters currently displayed, right-aligned
+    uint8_t visible_cells;                      // Number of non-blank cells
+    int32_t cell_w;
+    int32_t cell_h;
+    int32_t value;                              // Last value set, for the roll direction
+    bool has_value;
+    uint32_t anim_ms;                           // 0 disables the rolling animation
+    uint32_t cells_updated;                     // Stats: cells redrawn
+    uint32_t cells_skipped;                     // Stats: cells left untouched
+} ui_digit_readout_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates the readout under parent. unit may be NULL. anim_ms = 0 for no animation.
+void ui_digit_readout_create(ui_digit_readout_t* readout, lv_obj_t* parent, const lv_font_t* font,
+                             lv_color_t color, const char* unit, uint32_t anim_ms);
+
+// Shows an integer value. Returns true if any cell changed.
+bool ui_digit_readout_set_value(ui_digit_readout_t* readout, int32_t value);
+
+// Shows arbitrary text (at most UI_READOUT_MAX_CELLS characters), e.g. a placeholder.
+bool ui_digit_readout_set_text(ui_digit_readout_t* readout, const char* text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_DIGIT_READOUT_H
@@ -0,0 +1,85 @@
+/*
+ * Knob input device implementation.
+ *
+ * The indev read timer is paused: detents wake the LVGL task through the
+ * mailbox knob ring, and ui_encoder_process() reads the device only while
+ * the ring has events. Each read hands LVGL exactly one detent and asks to
+ * be called again (continue_reading) while more are queued, so key handlers
+ * still see every detent with its own timestamp.
+ *
+ * Screens switch the device's group on LV_EVENT_SCREEN_LOADED; any other
+ * screen (ambient, calibration, transition stage) leaves it without a group
+ * and LVGL drops the detents.
+ */
+
+#include "ui_encoder.h"
+#include "ui_mailbox.h"
+
+static lv_indev_t* knob_indev = NULL;
+static uint32_t event_ms = 0;
+static lv_group_focus_cb_t focus_hook = NULL;
+
+static void knob_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {
+    ui_knob_event_t event;
+    data->state = LV_INDEV_STATE_RELEASED; // No push button
+    if (ui_mailbox_pop_knob(&event, 1) == 1) {
+        data->enc_diff = event.delta;
+        event_ms = event.t_ms;
+    } else {
+        data->enc_diff = 0;
+    }
+    data->continue_reading = ui_mailbox_knob_pending() > 0;
+}
+
+lv_indev_t* ui_encoder_init(void) {
+    knob_indev = lv_indev_create();
+    lv_indev_set_type(knob_indev, LV_INDEV_TYPE_ENCODER);
+    lv_indev_set_read_cb(knob_indev, knob_read_cb);
+    lv_timer_pause(lv_indev_get_read_timer(knob_indev)); // Read on demand in ui_encoder_process()
+    return knob_indev;
+}
+
+// Focus changes (taps, lv_group_focus_obj) leave edit mode; re-enter it so the
+// next detent edits the newly focused object instead of moving focus.
+static void group_focus_cb(lv_group_t* group) {
+    lv_group_set_editing(group, true);
+    if (focus_hook) focus_hook(group);
+}
+
+void ui_encoder_set_focus_hook(lv_group_focus_cb_t hook) {
+    focus_hook = hook;
+}
+
+lv_group_t* ui_encoder_create_group(void) {
+    lv_group_t* group = lv_group_create();
+    lv_group_set_focus_cb(group, group_focus_cb);
+    lv_group_set_wrap(group, false);
+    lv_group_set_editing(group, true);
+    return group;
+}
+
+static void screen_event_cb(lv_event_t* e) {
+    if (!knob_indev) return;
+    if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOADED) {
+        lv_indev_set_group(knob_indev, (lv_group_t*)lv_event_get_user_data(e));
+    } else {
+        lv_indev_set_group(knob_indev, NULL);
+    }
+}
+
+void ui_encoder_attach_screen(lv_obj_t* screen, lv_group_t* group) {
+    lv_obj_add_event_cb(screen, screen_event_cb, LV_EVENT_SCREEN_LOADED, group);
+    lv_obj_add_event_cb(screen, screen_event_cb, LV_EVENT_SCREEN_UNLOAD_START, group);
+    if (knob_indev && lv_screen_active() == screen) lv_indev_set_group(knob_indev, group);
+}
+
+uint32_t ui_encoder_process(void) {
+    uint32_t pending = ui_mailbox_knob_pending();
+    if (pending == 0 || !knob_indev) return 0;
+    lv_indev_read(knob_indev);
+    return pending;
+}
+
+uint32_t ui_encoder_event_ms(void) {
+    return event_ms;
+}
@@ -0,0 +1,47 @@
+/*
+ * Header for the knob's LVGL input device.
+ *
+ * Registers the rotary encoder as an LV_INDEV_TYPE_ENCODER fed from the
+ * mailbox knob ring, so focus and editing go through LVGL groups: each
+ * screen owns a group, the focused object receives LV_EVENT_KEY with
+ * LV_KEY_LEFT/RIGHT per detent. The knob has no push button, so groups
+ * are kept in edit mode and focus changes come from taps (click focus).
+ */
+#ifndef UI_ENCODER_H
+#define UI_ENCODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates the encoder input device. LVGL task / lock held, after the display exists.
+lv_indev_t* ui_encoder_init(void);
+
+// Creates a group in permanent edit mode, for one screen.
+lv_group_t* ui_encoder_create_group(void);
+
+// Called once per focus change of any ui_encoder group, after the new object is focused.
+// Use it instead of LV_EVENT_FOCUSED for selection side effects: re-entering edit mode
+// makes LVGL send FOCUSED again, including to the object that is losing focus.
+void ui_encoder_set_focus_hook(lv_group_focus_cb_t hook);
+
+// Routes the knob to `group` whenever `screen` is the active screen.
+void ui_encoder_attach_screen(lv_obj_t* screen, lv_group_t* group);
+
+// Called by the LVGL task once per cycle: feeds every queued detent through LVGL's
+// input pipeline. Returns the number of detents delivered.
+uint32_t ui_encoder_process(void);
+
+// millis() timestamp of the detent currently being delivered (for knob_accel);
+// only meaningful inside an LV_EVENT_KEY handler.
+uint32_t ui_encoder_event_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_ENCODER_H
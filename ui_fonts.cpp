@@ -0,0 +1,170 @@
+/*
+ * UI font set and decoded-glyph cache implementation.
+ *
+ * Each font is wrapped in an lv_font_t whose get_glyph_dsc forwards to the
+ * real font and whose get_glyph_bitmap consults the cache first. On a miss
+ * the real font decodes into LVGL's A8 glyph buffer as usual and the rows
+ * are copied into a PSRAM entry; on a hit the rows are copied back out.
+ * Entries are evicted least-recently-used once the entry count or byte
+ * budget is reached.
+ *
+ * Written against the LVGL 9.2 font driver interface
+ * (get_glyph_bitmap(lv_font_glyph_dsc_t*, lv_draw_buf_t*)); 9.0/9.1 pass the
+ * letter as an extra argument and are rejected at compile time.
+ */
+
+#include "ui_fonts.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <string.h>
+
+#if LVGL_VERSION_MAJOR != 9 || LVGL_VERSION_MINOR < 2
+#error "ui_fonts.cpp implements the LVGL 9.2+ get_glyph_bitmap signature"
+#endif
+
+const lv_font_t* ui_font_small = NULL;
+const lv_font_t* ui_font_medium = NULL;
+const lv_font_t* ui_font_large = NULL;
+
+typedef struct {
+    const lv_font_t* font;      // Wrapper font the glyph belongs to, NULL if free
+    uint32_t glyph_index;
+    uint32_t stride;
+    uint16_t h;
+    uint32_t last_use;
+    uint8_t* data;
+} glyph_entry_t;
+
+typedef struct {
+    lv_font_t font;             // What the UI uses
+    const lv_font_t* base;      // Font that actually decodes
+} cached_font_t;
+
+static cached_font_t cached_small;
+static cached_font_t cached_medium;
+static cached_font_t cached_large;
+
+static glyph_entry_t entries[UI_GLYPH_CACHE_ENTRIES];
+static uint32_t use_clock = 0;
+static uint32_t cache_bytes = 0;
+static uint32_t cache_entries = 0;
+static uint32_t stat_hits = 0;
+static uint32_t stat_misses = 0;
+static uint32_t stat_evictions = 0;
+static uint64_t stat_hit_us = 0;
+static uint64_t stat_decode_us = 0;
+
+static void evict(glyph_entry_t* entry) {
+    heap_caps_free(entry->data);
+    cache_bytes -= entry->stride * entry->h;
+    cache_entries--;
+    entry->font = NULL;
+    entry->data = NULL;
+    stat_evictions++;
+}
+
+// Frees least-recently-used entries until size more bytes fit; returns a free slot
+static glyph_entry_t* make_room(uint32_t size) {
+    for (;;) {
+        glyph_entry_t* free_slot = NULL;
+        glyph_entry_t* oldest = NULL;
+        for (glyph_entry_t& entry : entries) {
+            if (!entry.font) {
+                if (!free_slot) free_slot = &entry;
+            } else if (!oldest || entry.last_use < oldest->last_use) {
+                oldest = &entry;
+            }
+        }
+        if (free_slot && cache_bytes + size <= UI_GLYPH_CACHE_BYTES) return free_slot;
+        if (!oldest) return NULL;
+        evict(oldest);
+    }
+}
+
+static bool cached_get_glyph_dsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter,
+                                 uint32_t letter_next) {
+    const cached_font_t* cached = (const cached_font_t*)font->user_data;
+    return cached->base->get_glyph_dsc(cached->base, dsc, letter, letter_next);
+}
+
+static const void* cached_get_glyph_bitmap(lv_font_glyph_dsc_t* g_dsc, lv_draw_buf_t* draw_buf) {
+    const lv_font_t* font = g_dsc->resolved_font;
+    const cached_font_t* cached = (const cached_font_t*)font->user_data;
+    const uint32_t glyph_index = g_dsc->gid.index;
+    const uint32_t stride = draw_buf->header.stride;
+    const uint16_t h = g_dsc->box_h;
+
+    int64_t start_us = esp_timer_get_time();
+    for (glyph_entry_t& entry : entries) {
+        if (entry.font == font && entry.glyph_index == glyph_index && entry.stride == stride) {
+            memcpy(draw_buf->data, entry.data, stride * h);
+            entry.last_use = ++use_clock;
+            stat_hits++;
+            stat_hit_us += esp_timer_get_time() - start_us; // Includes the lookup
+            return draw_buf;
+        }
+    }
+
+    // Miss: let the real font decode, then keep a copy
+    stat_misses++;
+    g_dsc->resolved_font = cached->base;
+    start_us = esp_timer_get_time();
+    const void* result = cached->base->get_glyph_bitmap(g_dsc, draw_buf);
+    stat_decode_us += esp_timer_get_time() - start_us;
+    g_dsc->resolved_font = font;
+    if (result != draw_buf || h == 0) return result;
+
+    const uint32_t size = stride * h;
+    if (size > UI_GLYPH_CACHE_BYTES / 4) return result; // Don't let one glyph flush the cache
+    glyph_entry_t* slot = make_room(size);
+    if (!slot) return result;
+    slot->data = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!slot->data) return result;
+    memcpy(slot->data, draw_buf->data, size);
+    slot->font = font;
+    slot->glyph_index = glyph_index;
+    slot->stride = stride;
+    slot->h = h;
+    slot->last_use = ++use_clock;
+    cache_bytes += size;
+    cache_entries++;
+    return result;
+}
+
+static const lv_font_t* wrap(cached_font_t* cached, const lv_font_t* base) {
+#if UI_GLYPH_CACHE_BYTES > 0
+    cached->base = base;
+    cached->font = *base;
+    cached->font.get_glyph_dsc = cached_get_glyph_dsc;
+    cached->font.get_glyph_bitmap = cached_get_glyph_bitmap;
+    cached->font.release_glyph = NULL;
+    cached->font.user_data = cached;
+    return &cached->font;
+#else
+    (void)cached;
+    return base;
+#endif
+}
+
+void ui_fonts_init(void) {
+    ui_font_small = wrap(&cached_small, &lv_font_montserrat_16);
+    ui_font_medium = wrap(&cached_medium, &lv_font_montserrat_24);
+#if LV_FONT_MONTSERRAT_48
+    ui_font_large = wrap(&cached_large, &lv_font_montserrat_48);
+#else
+    #warning "LV_FONT_MONTSERRAT_48 not enabled in lv_conf.h, using smaller font for weight."
+    ui_font_large = ui_font_medium;
+#endif
+    Serial.println("Fonts: stock Montserrat");
+}
+
+void ui_fonts_get_stats(ui_fonts_stats_t* stats) {
+    stats->hits = stat_hits;
+    stats->misses = stat_misses;
+    stats->evictions = stat_evictions;
+    stats->hit_us = (uint32_t)stat_hit_us;
+    stats->decode_us = (uint32_t)stat_decode_us;
+    stats->entries = cache_entries;
+    stats->bytes = cache_bytes;
+}
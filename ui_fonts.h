@@ -0,0 +1,51 @@
+/*
+ * Header for the UI font set and decoded-glyph cache.
+ *
+ * The UI uses three sizes (16/24/48 px) of the stock LVGL Montserrat fonts,
+ * selected in one place so screens don't name lv_font_montserrat_* directly.
+ *
+ * Each font is wrapped so decoded glyph bitmaps are kept in a
+ * bounded PSRAM cache; a cache hit is a row copy instead of a decompress/
+ * unpack, which matters most for the 48 px digits redrawn on every knob tick.
+ * Whether that actually beats decoding from flash is measured, not assumed:
+ * the stats time every cache hit and every real decode (profiler 'p').
+ */
+#ifndef UI_FONTS_H
+#define UI_FONTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <lvgl.h>
+
+#define UI_GLYPH_CACHE_BYTES (48 * 1024)    // PSRAM budget for decoded glyphs, 0 disables the cache
+#define UI_GLYPH_CACHE_ENTRIES 128          // Maximum cached glyphs
+
+// Valid after ui_fonts_init()
+extern const lv_font_t* ui_font_small;      // 16 px: battery, profiler overlay
+extern const lv_font_t* ui_font_medium;     // 24 px: titles, presets, status icons
+extern const lv_font_t* ui_font_large;      // 48 px: weight readout
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t hit_us;            // Total time copying cached glyphs out
+    uint32_t decode_us;         // Total time the real font spent decoding (one per miss)
+    uint32_t entries;
+    uint32_t bytes;             // Decoded bitmap bytes currently cached
+} ui_fonts_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Selects the fonts and sets up the cache. Call from the LVGL task before building screens.
+void ui_fonts_init(void);
+
+void ui_fonts_get_stats(ui_fonts_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_FONTS_H
@@ -0,0 +1,173 @@
+/*
+ * UI update mailbox implementation.
+ *
+ * A fixed table of slots, one per ui_msg_type_t, plus an atomic bitmask of
+ * pending slots. A producer stores the new value into its slot and then sets
+ * the slot's bit (release); the LVGL task swaps the mask to zero (acquire)
+ * and reads the slots. Both sides are wait-free, so the BLE/MQTT tasks and
+ * the knob's esp_timer callback never wait on the LVGL mutex.
+ *
+ * If a producer overwrites a slot between the consumer clearing the mask and
+ * reading the value, the newer value is applied now and again next cycle,
+ * which is harmless for "latest value wins" widgets.
+ *
+ * The sample and knob rings are single-producer/single-consumer queues: the
+ * producer owns the head index, the LVGL task owns the tail, and each
+ * publishes its index with release ordering after touching the slots.
+ */
+
+#include "ui_mailbox.h"
+#include "lcd_bsp.h" // lcd_lvgl_wake()
+#include <atomic>
+#include <cstring>
+
+static_assert(UI_MSG_COUNT <= 32, "pending mask is 32 bits wide");
+static_assert((UI_SAMPLE_RING_SIZE & (UI_SAMPLE_RING_SIZE - 1)) == 0, "sample ring size must be a power of two");
+static_assert((UI_KNOB_RING_SIZE & (UI_KNOB_RING_SIZE - 1)) == 0, "knob ring size must be a power of two");
+
+static std::atomic<uint32_t> slot_values[UI_MSG_COUNT];
+static std::atomic<uint32_t> pending_mask(0);
+static std::atomic<uint32_t> stat_posted(0);
+static std::atomic<uint32_t> stat_delivered(0);
+
+static ui_sample_t sample_ring[UI_SAMPLE_RING_SIZE];
+static std::atomic<uint32_t> sample_head(0); // Next slot to write (producer)
+static std::atomic<uint32_t> sample_tail(0); // Next slot to read (consumer)
+static std::atomic<uint32_t> stat_samples_pushed(0);
+static std::atomic<uint32_t> stat_samples_dropped(0);
+
+static ui_knob_event_t knob_ring[UI_KNOB_RING_SIZE];
+static std::atomic<uint32_t> knob_head(0); // Next slot to write (producer)
+static std::atomic<uint32_t> knob_tail(0); // Next slot to read (consumer)
+static std::atomic<uint32_t> stat_knob_pushed(0);
+static std::atomic<uint32_t> stat_knob_dropped(0);
+
+static void post_raw(ui_msg_type_t type, uint32_t raw) {
+    if (type >= UI_MSG_COUNT) return;
+    slot_values[type].store(raw, std::memory_order_relaxed);
+    uint32_t previous = pending_mask.fetch_or(1UL << type, std::memory_order_release);
+    stat_posted.fetch_add(1, std::memory_order_relaxed);
+    if (previous == 0) {
+        // Only the first message of a batch needs to wake the LVGL task
+        lcd_lvgl_wake();
+    }
+}
+
+void ui_mailbox_post_int(ui_msg_type_t type, int32_t value) {
+    post_raw(type, (uint32_t)value);
+}
+
+void ui_mailbox_post_float(ui_msg_type_t type, float value) {
+    uint32_t raw;
+    memcpy(&raw, &value, sizeof(raw));
+    post_raw(type, raw);
+}
+
+void ui_mailbox_post_bool(ui_msg_type_t type, bool value) {
+    post_raw(type, value ? 1 : 0);
+}
+
+uint32_t ui_mailbox_take(ui_msg_value_t values[UI_MSG_COUNT]) {
+    uint32_t mask = pending_mask.exchange(0, std::memory_order_acquire);
+    if (mask == 0) return 0;
+
+    for (int type = 0; type < UI_MSG_COUNT; type++) {
+        if (!(mask & (1UL << type))) continue;
+        uint32_t raw = slot_values[type].load(std::memory_order_relaxed);
+        switch (type) {
+            case UI_MSG_HA_TEMP:
+            case UI_MSG_HA_PREINF_TIME:
+            case UI_MSG_HA_LAST_SHOT:
+                memcpy(&values[type].f, &raw, sizeof(raw));
+                break;
+            case UI_MSG_CHECKMARK:
+            case UI_MSG_HA_POWER:
+            case UI_MSG_POWER_PROFILE:
+                values[type].b = (raw != 0);
+                break;
+            default:
+                values[type].i = (int32_t)raw;
+                break;
+        }
+        stat_delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+    return mask;
+}
+
+void ui_mailbox_get_stats(uint32_t* posted, uint32_t* delivered) {
+    if (posted) *posted = stat_posted.load(std::memory_order_relaxed);
+    if (delivered) *delivered = stat_delivered.load(std::memory_order_relaxed);
+}
+
+bool ui_mailbox_push_sample(ui_sample_kind_t kind, uint32_t t_ms, float value) {
+    uint32_t head = sample_head.load(std::memory_order_relaxed);
+    uint32_t tail = sample_tail.load(std::memory_order_acquire);
+    if (head - tail >= UI_SAMPLE_RING_SIZE) {
+        stat_samples_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ui_sample_t& slot = sample_ring[head & (UI_SAMPLE_RING_SIZE - 1)];
+    slot.t_ms = t_ms;
+    slot.value = value;
+    slot.kind = (uint8_t)kind;
+    sample_head.store(head + 1, std::memory_order_release);
+    stat_samples_pushed.fetch_add(1, std::memory_order_relaxed);
+    lcd_lvgl_wake(); // Every sample (10-20 Hz): an "was empty" check can miss a concurrent drain
+    return true;
+}
+
+uint32_t ui_mailbox_pop_samples(ui_sample_t* out, uint32_t max) {
+    uint32_t tail = sample_tail.load(std::memory_order_relaxed);
+    uint32_t head = sample_head.load(std::memory_order_acquire);
+    uint32_t count = head - tail;
+    if (count > max) count = max;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = sample_ring[(tail + i) & (UI_SAMPLE_RING_SIZE - 1)];
+    }
+    sample_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+void ui_mailbox_get_sample_stats(uint32_t* pushed, uint32_t* dropped) {
+    if (pushed) *pushed = stat_samples_pushed.load(std::memory_order_relaxed);
+    if (dropped) *dropped = stat_samples_dropped.load(std::memory_order_relaxed);
+}
+
+bool ui_mailbox_push_knob(int8_t delta, uint32_t t_ms) {
+    uint32_t head = knob_head.load(std::memory_order_relaxed);
+    uint32_t tail = knob_tail.load(std::memory_order_acquire);
+    if (head - tail >= UI_KNOB_RING_SIZE) {
+        stat_knob_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ui_knob_event_t& slot = knob_ring[head & (UI_KNOB_RING_SIZE - 1)];
+    slot.t_ms = t_ms;
+    slot.delta = delta;
+    knob_head.store(head + 1, std::memory_order_release);
+    stat_knob_pushed.fetch_add(1, std::memory_order_relaxed);
+    // Wake on every detent: "ring was empty" judged from the tail loaded above can miss a
+    // drain that finished in between, and the notification is cheap at knob rates.
+    lcd_lvgl_wake();
+    return true;
+}
+
+uint32_t ui_mailbox_pop_knob(ui_knob_event_t* out, uint32_t max) {
+    uint32_t tail = knob_tail.load(std::memory_order_relaxed);
+    uint32_t head = knob_head.load(std::memory_order_acquire);
+    uint32_t count = head - tail;
+    if (count > max) count = max;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = knob_ring[(tail + i) & (UI_KNOB_RING_SIZE - 1)];
+    }
+    knob_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+uint32_t ui_mailbox_knob_pending(void) {
+    return knob_head.load(std::memory_order_acquire) - knob_tail.load(std::memory_order_relaxed);
+}
+
+void ui_mailbox_get_knob_stats(uint32_t* pushed, uint32_t* dropped) {
+    if (pushed) *pushed = stat_knob_pushed.load(std::memory_order_relaxed);
+    if (dropped) *dropped = stat_knob_dropped.load(std::memory_order_relaxed);
+}
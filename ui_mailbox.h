@@ -0,0 +1,110 @@
+/*
+ * Header for the UI update mailbox.
+ *
+ * Lets any task (BLE, MQTT, FreeRTOS timer service, esp_timer callbacks)
+ * request a widget update without touching LVGL or taking the LVGL mutex.
+ * Each widget has one slot holding its latest requested value, so repeated
+ * updates to the same widget coalesce. The LVGL task drains the mailbox once
+ * per cycle and applies what changed.
+ *
+ * Time series (the live shot weight) can't coalesce, so they use a separate
+ * fixed-size sample ring that keeps every sample in order. Knob detents get
+ * their own small ring for the same reason: each one carries its timestamp
+ * so the consumer can still compute acceleration after batching.
+ */
+#ifndef UI_MAILBOX_H
+#define UI_MAILBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One message type per widget that can be updated from outside the LVGL task
+typedef enum {
+    UI_MSG_WEIGHT,              // int8_t target weight (g)
+    UI_MSG_CHECKMARK,           // bool, true = show verification checkmark
+    UI_MSG_BLE_STATUS,          // ble_status_t
+    UI_MSG_BATTERY,             // uint8_t percentage
+    UI_MSG_HA_POWER,            // bool machine power
+    UI_MSG_HA_MODE,             // int8_t pre-infusion mode index
+    UI_MSG_HA_TEMP,             // float target temperature (C)
+    UI_MSG_HA_STEAM,            // int steam power level
+    UI_MSG_HA_PREINF_TIME,      // float pre-infusion time (s)
+    UI_MSG_HA_LAST_SHOT,        // float last shot duration (s)
+    UI_MSG_BATTERY_RUNTIME,     // uint16_t estimated minutes left (POWER_RUNTIME_UNKNOWN = none)
+    UI_MSG_POWER_PROFILE,       // bool, true = low-power profile (settings read from power_profile)
+    UI_MSG_COUNT
+} ui_msg_type_t;
+
+// Payload of a single message; which member is valid depends on the type
+typedef union {
+    int32_t i;
+    float f;
+    bool b;
+} ui_msg_value_t;
+
+// --- Sample stream ---
+#define UI_SAMPLE_RING_SIZE 256 // Power of two; ~12 s of backlog at 20 Hz
+
+typedef enum {
+    UI_SAMPLE_VALUE,            // One measurement
+    UI_SAMPLE_START,            // Start of a series (value unused)
+    UI_SAMPLE_END               // End of a series (value unused)
+} ui_sample_kind_t;
+
+typedef struct {
+    uint32_t t_ms;              // millis() when the producer pushed the sample
+    float value;
+    uint8_t kind;               // ui_sample_kind_t
+} ui_sample_t;
+
+// --- Knob events ---
+#define UI_KNOB_RING_SIZE 64 // Power of two; far more detents than one LVGL cycle can see
+
+typedef struct {
+    uint32_t t_ms;              // millis() of the detent
+    int8_t delta;               // +1 right, -1 left
+} ui_knob_event_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Producers: safe from any task, never block. Wakes the LVGL task.
+void ui_mailbox_post_int(ui_msg_type_t type, int32_t value);
+void ui_mailbox_post_float(ui_msg_type_t type, float value);
+void ui_mailbox_post_bool(ui_msg_type_t type, bool value);
+
+// Consumer (LVGL task only): copies the latest value of every pending slot into
+// values[] and returns a bitmask of the slots that were pending.
+uint32_t ui_mailbox_take(ui_msg_value_t values[UI_MSG_COUNT]);
+
+// Counters: messages posted vs. messages actually applied after coalescing
+void ui_mailbox_get_stats(uint32_t* posted, uint32_t* delivered);
+
+// Sample producer: one task only, never blocks. Returns false (and counts a drop)
+// if the ring is full. Wakes the LVGL task when the ring was empty.
+bool ui_mailbox_push_sample(ui_sample_kind_t kind, uint32_t t_ms, float value);
+
+// Sample consumer (LVGL task only): copies up to max samples, oldest first.
+uint32_t ui_mailbox_pop_samples(ui_sample_t* out, uint32_t max);
+
+void ui_mailbox_get_sample_stats(uint32_t* pushed, uint32_t* dropped);
+
+// Knob producer: one task only (the knob's esp_timer callback or knob task), never
+// blocks. Returns false (and counts a drop) if the ring is full. Wakes the LVGL task
+// when the ring was empty.
+bool ui_mailbox_push_knob(int8_t delta, uint32_t t_ms);
+
+// Knob consumer (LVGL task only): copies up to max events, oldest first.
+uint32_t ui_mailbox_pop_knob(ui_knob_event_t* out, uint32_t max);
+
+// Knob consumer (LVGL task only): number of queued events.
+uint32_t ui_mailbox_knob_pending(void);
+
+void ui_mailbox_get_knob_stats(uint32_t* pushed, uint32_t* dropped);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_MAILBOX_H
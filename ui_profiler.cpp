@@ -0,0 +1,276 @@
+/*
+ * On-device render/flush profiler implementation.
+ *
+ * Histograms use power-of-two buckets: bucket n counts values in
+ * [2^(n-1), 2^n), bucket 0 counts zeros. All recording happens in the LVGL
+ * task, so the counters are plain integers; requests from other tasks are
+ * single flags that wake the LVGL task.
+ */
+
+#include "ui_profiler.h"
+
+#if UI_PROFILER_ENABLED
+
+#include "lcd_bsp.h"   // lcd_lvgl_wake(), lcd_lvgl_get_wakeups_per_sec()
+#include "ui_mailbox.h"
+#include "ui_binding.h"
+#include "ui_fonts.h"
+#include "ui_theme.h"
+#include "lvgl_display.h" // screen_shot_stopper, screen_ha
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <lvgl.h>
+#include <atomic>
+
+#define UI_PROF_BUCKETS 20
+#define UI_PROF_OVERLAY_PERIOD_MS 500
+
+typedef struct {
+    const char* name;
+    const char* unit;
+    uint32_t buckets[UI_PROF_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+} prof_hist_t;
+
+static prof_hist_t hist_render = {"render/frame", "us"};
+static prof_hist_t hist_flush_us = {"flush time", "us"};
+static prof_hist_t hist_flush_bytes = {"flush size", "B"};
+static prof_hist_t hist_area_px = {"area size", "px"};
+static prof_hist_t hist_areas = {"areas/frame", ""};
+static prof_hist_t hist_handler = {"timer_handler", "us"};
+static prof_hist_t* const ALL_HISTS[] = {
+    &hist_render, &hist_flush_us, &hist_flush_bytes, &hist_area_px, &hist_areas, &hist_handler,
+};
+
+// Per-frame accumulators
+static int64_t frame_start_us = 0;
+static uint32_t frame_flush_us = 0;     // Time the LVGL task spent in or waiting on flushes
+static int64_t flush_block_start_us = 0;
+static uint32_t frame_areas = 0;
+static uint32_t frames = 0;
+
+static size_t heap_high_water = 0;
+
+static std::atomic<bool> dump_requested(false);
+static std::atomic<bool> overlay_toggle_requested(false);
+static std::atomic<bool> reset_requested(false);
+static std::atomic<bool> screen_stats_requested(false);
+
+static lv_obj_t* overlay_label = NULL;
+static lv_timer_t* overlay_timer = NULL;
+
+static void hist_add(prof_hist_t* h, uint32_t value) {
+    uint32_t bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+    if (bucket >= UI_PROF_BUCKETS) bucket = UI_PROF_BUCKETS - 1;
+    h->buckets[bucket]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
+
+static uint32_t hist_avg(const prof_hist_t* h) {
+    return h->count ? (uint32_t)(h->sum / h->count) : 0;
+}
+
+// Upper bound of the bucket containing the given percentile (approximate)
+static uint32_t hist_percentile(const prof_hist_t* h, uint32_t pct) {
+    if (h->count == 0) return 0;
+    uint32_t target = (h->count * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (int b = 0; b < UI_PROF_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= target) return b == 0 ? 0 : (1UL << b) - 1;
+    }
+    return h->max;
+}
+
+static void sample_heap(void) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (mon.max_used > heap_high_water) heap_high_water = mon.max_used;
+}
+
+static void refr_start_cb(lv_event_t* e) {
+    frame_start_us = esp_timer_get_time();
+    frame_flush_us = 0;
+}
+
+// Flush callback and flush waits: the part of a refresh that isn't rendering. A flush that
+// overlaps rendering of the next area costs the refresh nothing and isn't counted.
+static void flush_block_start_cb(lv_event_t* e) {
+    flush_block_start_us = esp_timer_get_time();
+}
+
+static void flush_block_end_cb(lv_event_t* e) {
+    if (flush_block_start_us == 0) return;
+    frame_flush_us += (uint32_t)(esp_timer_get_time() - flush_block_start_us);
+    flush_block_start_us = 0;
+}
+
+static void refr_ready_cb(lv_event_t* e) {
+    if (frame_start_us == 0) return;
+    uint32_t total_us = (uint32_t)(esp_timer_get_time() - frame_start_us);
+    // Report pure render time: drop the time the refresh was blocked on the panel
+    hist_add(&hist_render, total_us > frame_flush_us ? total_us - frame_flush_us : 0);
+    hist_add(&hist_areas, frame_areas);
+    frame_areas = 0;
+    frame_start_us = 0;
+    frames++;
+}
+
+static void overlay_timer_cb(lv_timer_t* timer) {
+    if (!overlay_label) return;
+    lv_label_set_text_fmt(overlay_label, "rnd %lu/%lu us\nfl %lu us %lu kB\nwk %d/s",
+                          (unsigned long)hist_avg(&hist_render), (unsigned long)hist_percentile(&hist_render, 95),
+                          (unsigned long)hist_avg(&hist_flush_us),
+                          (unsigned long)(hist_flush_bytes.sum / 1024),
+                          (int)lcd_lvgl_get_wakeups_per_sec());
+}
+
+static void toggle_overlay(void) {
+    if (overlay_label) {
+        lv_timer_del(overlay_timer);
+        overlay_timer = NULL;
+        lv_obj_del(overlay_label);
+        overlay_label = NULL;
+        Serial.println("Profiler overlay off.");
+        return;
+    }
+    overlay_label = lv_label_create(lv_layer_top());
+    lv_obj_set_style_text_font(overlay_label, ui_font_small, 0);
+    lv_obj_set_style_text_color(overlay_label, lv_color_make(255, 200, 0), 0);
+    lv_obj_set_style_bg_color(overlay_label, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(overlay_label, LV_OPA_70, 0);
+    // Top-left "corner" of the round panel that is still inside the visible circle
+    lv_obj_align(overlay_label, LV_ALIGN_TOP_LEFT, 60, 70);
+    overlay_timer = lv_timer_create(overlay_timer_cb, UI_PROF_OVERLAY_PERIOD_MS, NULL);
+    overlay_timer_cb(NULL);
+    Serial.println("Profiler overlay on.");
+}
+
+static void dump(void) {
+    sample_heap();
+    Serial.printf("--- UI profile: %lu frames ---\n", (unsigned long)frames);
+    for (prof_hist_t* h : ALL_HISTS) {
+        Serial.printf("%-14s n=%lu avg=%lu p50<=%lu p95<=%lu max=%lu %s\n", h->name,
+                      (unsigned long)h->count, (unsigned long)hist_avg(h),
+                      (unsigned long)hist_percentile(h, 50), (unsigned long)hist_percentile(h, 95),
+                      (unsigned long)h->max, h->unit);
+        Serial.print("   ");
+        for (int b = 0; b < UI_PROF_BUCKETS; b++) {
+            if (h->buckets[b]) Serial.printf(" <%lu:%lu", b == 0 ? 1UL : (1UL << b), (unsigned long)h->buckets[b]);
+        }
+        Serial.println();
+    }
+    uint32_t posted, delivered, applied, skipped, samples, dropped, knob_events, knob_dropped;
+    ui_mailbox_get_stats(&posted, &delivered);
+    ui_mailbox_get_sample_stats(&samples, &dropped);
+    ui_mailbox_get_knob_stats(&knob_events, &knob_dropped);
+    ui_binding_get_stats(&applied, &skipped);
+    Serial.printf("LVGL heap high-water: %lu bytes\n", (unsigned long)heap_high_water);
+    Serial.printf("LVGL task wakeups: %.1f/s\n", lcd_lvgl_get_wakeups_per_sec());
+    Serial.printf("Mailbox: %lu posted, %lu delivered\n", (unsigned long)posted, (unsigned long)delivered);
+    Serial.printf("Sample ring: %lu pushed, %lu dropped\n", (unsigned long)samples, (unsigned long)dropped);
+    Serial.printf("Knob ring: %lu pushed, %lu dropped\n", (unsigned long)knob_events, (unsigned long)knob_dropped);
+    ui_fonts_stats_t fonts;
+    ui_fonts_get_stats(&fonts);
+    uint32_t lookups = fonts.hits + fonts.misses;
+    Serial.printf("Glyph cache: %lu hits, %lu misses (%lu%% hit), %lu evictions, %lu glyphs / %lu bytes\n",
+                  (unsigned long)fonts.hits, (unsigned long)fonts.misses,
+                  (unsigned long)(lookups ? (uint64_t)fonts.hits * 100 / lookups : 0),
+                  (unsigned long)fonts.evictions, (unsigned long)fonts.entries, (unsigned long)fonts.bytes);
+    if (fonts.hits && fonts.misses) {
+        // The cache only pays off if a hit is cheaper than the decode it replaces
+        Serial.printf("Glyph cache: %.1f us per hit vs. %.1f us per flash decode\n",
+                      (float)fonts.hit_us / fonts.hits, (float)fonts.decode_us / fonts.misses);
+    }
+    Serial.printf("Label bindings: %lu applied, %lu skipped\n", (unsigned long)applied, (unsigned long)skipped);
+}
+
+static void reset(void) {
+    for (prof_hist_t* h : ALL_HISTS) {
+        const char* name = h->name;
+        const char* unit = h->unit;
+        *h = {};
+        h->name = name;
+        h->unit = unit;
+    }
+    frames = 0;
+    heap_high_water = 0;
+    Serial.println("Profiler reset.");
+}
+
+void ui_profiler_init(lv_display_t* disp) {
+    lv_display_add_event_cb(disp, refr_start_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_ready_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_add_event_cb(disp, flush_block_start_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(disp, flush_block_end_cb, LV_EVENT_FLUSH_FINISH, NULL);
+    lv_display_add_event_cb(disp, flush_block_start_cb, LV_EVENT_FLUSH_WAIT_START, NULL);
+    lv_display_add_event_cb(disp, flush_block_end_cb, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
+}
+
+void ui_profiler_record_flush(uint32_t bytes, uint32_t duration_us) {
+    hist_add(&hist_flush_bytes, bytes);
+    hist_add(&hist_flush_us, duration_us);
+}
+
+void ui_profiler_record_area(uint32_t pixels) {
+    hist_add(&hist_area_px, pixels);
+    frame_areas++;
+}
+
+void ui_profiler_record_handler(uint32_t duration_us) {
+    hist_add(&hist_handler, duration_us);
+}
+
+void ui_profiler_request_dump(void) {
+    dump_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+void ui_profiler_request_overlay_toggle(void) {
+    overlay_toggle_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+void ui_profiler_request_reset(void) {
+    reset_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+void ui_profiler_request_screen_stats(void) {
+    screen_stats_requested.store(true);
+    lcd_lvgl_wake();
+}
+
+static void screen_stats(void) {
+    const struct {
+        const char* name;
+        lv_obj_t* screen;
+    } screens[] = {{"shot stopper", screen_shot_stopper}, {"home assistant", screen_ha}};
+    Serial.printf("--- Screen stats, %s theme ---\n", ui_theme_name());
+    for (const auto& s : screens) {
+        ui_theme_measure_t m;
+        if (s.screen == NULL) {
+            Serial.printf("%-15s not built\n", s.name);
+        } else if (ui_theme_measure_screen(s.screen, &m)) {
+            Serial.printf("%-15s lit %lu/%lu px (%lu%%), emission %u%%, render %lu us\n", s.name,
+                          (unsigned long)m.lit_pixels, (unsigned long)m.total_pixels,
+                          (unsigned long)(m.total_pixels ? (uint64_t)m.lit_pixels * 100 / m.total_pixels : 0),
+                          (unsigned)m.emission_pct, (unsigned long)m.render_us);
+        } else {
+            Serial.printf("%-15s measurement failed (needs LV_USE_SNAPSHOT and PSRAM)\n", s.name);
+        }
+    }
+}
+
+void ui_profiler_poll(void) {
+    if (reset_requested.exchange(false)) reset();
+    if (overlay_toggle_requested.exchange(false)) toggle_overlay();
+    if (dump_requested.exchange(false)) dump();
+    if (screen_stats_requested.exchange(false)) screen_stats();
+}
+
+#endif // UI_PROFILER_ENABLED
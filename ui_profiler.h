@@ -0,0 +1,68 @@
+/*
+ * Header for the on-device render/flush profiler.
+ *
+ * Collects per-frame render time, flush bytes/duration, invalidated area
+ * count/size, lv_timer_handler() duration and the LVGL heap high-water mark
+ * into fixed-size log2 histograms. Recording is a few adds per event, so it
+ * stays compiled in for production; set UI_PROFILER_ENABLED to 0 to strip it.
+ *
+ * Results can be shown in a small overlay (ui_profiler_request_overlay_toggle)
+ * or dumped over Serial (ui_profiler_request_dump).
+ */
+#ifndef UI_PROFILER_H
+#define UI_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef UI_PROFILER_ENABLED
+#define UI_PROFILER_ENABLED 1
+#endif
+
+// Forward declare lv_display_t type instead of including the full header
+struct _lv_display_t;
+typedef struct _lv_display_t lv_display_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if UI_PROFILER_ENABLED
+
+// Hooks the display's refresh events. Call from the LVGL task after the display exists.
+void ui_profiler_init(lv_display_t* disp);
+
+// Recording hooks (LVGL task only). Flush duration is queue to transfer done; it may be
+// recorded after the refresh it belongs to.
+void ui_profiler_record_flush(uint32_t bytes, uint32_t duration_us);
+void ui_profiler_record_area(uint32_t pixels);
+void ui_profiler_record_handler(uint32_t duration_us);
+
+// Requests from other tasks (e.g. Serial commands); handled in ui_profiler_poll()
+void ui_profiler_request_dump(void);
+void ui_profiler_request_overlay_toggle(void);
+void ui_profiler_request_reset(void);
+void ui_profiler_request_screen_stats(void); // Lit-pixel ratio + render time per screen
+
+// Services pending requests. Call from the LVGL task with the lock held.
+void ui_profiler_poll(void);
+
+#else
+
+static inline void ui_profiler_init(lv_display_t* disp) { (void)disp; }
+static inline void ui_profiler_record_flush(uint32_t bytes, uint32_t duration_us) { (void)bytes; (void)duration_us; }
+static inline void ui_profiler_record_area(uint32_t pixels) { (void)pixels; }
+static inline void ui_profiler_record_handler(uint32_t duration_us) { (void)duration_us; }
+static inline void ui_profiler_request_dump(void) {}
+static inline void ui_profiler_request_overlay_toggle(void) {}
+static inline void ui_profiler_request_reset(void) {}
+static inline void ui_profiler_request_screen_stats(void) {}
+static inline void ui_profiler_poll(void) {}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_PROFILER_H
@@ -0,0 +1,179 @@
+/*
+ * Live shot graph implementation.
+ *
+ * The plot is drawn in LV_EVENT_DRAW_MAIN straight from the column arrays:
+ * one 1 px wide filled rect per column spanning its min..max, restricted to
+ * the columns inside the current clip area. A regular sample therefore
+ * costs one narrow invalidation and a redraw of a couple of columns.
+ *
+ * Each column also includes the previous sample's value, so the trace stays
+ * connected; columns skipped between two samples get the interpolated value.
+ */
+
+#include "ui_shot_graph.h"
+#include <math.h>
+
+#define UI_SHOT_GRAPH_MIN_Y_MAX 10.0f    // Smallest vertical scale (g)
+#define UI_SHOT_GRAPH_HEADROOM 1.25f     // Scale = value * headroom when a sample exceeds it
+
+static inline bool col_empty(const ui_shot_graph_t* graph, int32_t col) {
+    return graph->col_min[col] > graph->col_max[col];
+}
+
+static void clear_columns(ui_shot_graph_t* graph, int32_t from) {
+    for (int32_t i = from; i < graph->width; i++) {
+        graph->col_min[i] = INFINITY;
+        graph->col_max[i] = -INFINITY;
+    }
+}
+
+static int32_t value_to_y(const ui_shot_graph_t* graph, const lv_area_t* coords, float value) {
+    int32_t h = lv_area_get_height(coords);
+    float v = value < 0 ? 0 : (value > graph->y_max ? graph->y_max : value);
+    return coords->y2 - (int32_t)lroundf(v / graph->y_max * (h - 1));
+}
+
+static void draw_cb(lv_event_t* e) {
+    ui_shot_graph_t* graph = (ui_shot_graph_t*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+    lv_area_t coords;
+    lv_obj_get_coords(graph->obj, &coords);
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_opa = LV_OPA_COVER;
+
+    if (graph->target > 0) {
+        dsc.bg_color = lv_color_hex(0x404040);
+        int32_t y = value_to_y(graph, &coords, graph->target);
+        lv_area_t line = {coords.x1, y, coords.x2, y};
+        lv_draw_rect(layer, &dsc, &line);
+    }
+
+    // Only walk the columns that intersect the area being redrawn
+    int32_t first = LV_MAX(layer->_clip_area.x1, coords.x1) - coords.x1;
+    int32_t last = LV_MIN(layer->_clip_area.x2, coords.x2) - coords.x1;
+    if (last > graph->last_col) last = graph->last_col;
+
+    dsc.bg_color = graph->color;
+    for (int32_t col = first; col <= last; col++) {
+        if (col_empty(graph, col)) continue;
+        lv_area_t bar;
+        bar.x1 = coords.x1 + col;
+        bar.x2 = bar.x1;
+        bar.y1 = value_to_y(graph, &coords, graph->col_max[col]);
+        bar.y2 = value_to_y(graph, &coords, graph->col_min[col]);
+        lv_draw_rect(layer, &dsc, &bar);
+    }
+}
+
+// Merges column pairs and doubles the time per column
+static void compress(ui_shot_graph_t* graph) {
+    int32_t half = graph->width / 2;
+    for (int32_t i = 0; i < half; i++) {
+        graph->col_min[i] = fminf(graph->col_min[2 * i], graph->col_min[2 * i + 1]);
+        graph->col_max[i] = fmaxf(graph->col_max[2 * i], graph->col_max[2 * i + 1]);
+    }
+    clear_columns(graph, half);
+    graph->ms_per_col *= 2;
+    if (graph->last_col > 0) graph->last_col /= 2; // -1 (no samples yet) stays -1
+}
+
+// Adds value to a column and invalidates the rows whose pixels changed
+static void extend_column(ui_shot_graph_t* graph, const lv_area_t* coords, int32_t col, float value,
+                          bool invalidate) {
+    bool was_empty = col_empty(graph, col);
+    int32_t old_top = was_empty ? 0 : value_to_y(graph, coords, graph->col_max[col]);
+    int32_t old_bottom = was_empty ? 0 : value_to_y(graph, coords, graph->col_min[col]);
+    if (value < graph->col_min[col]) graph->col_min[col] = value;
+    if (value > graph->col_max[col]) graph->col_max[col] = value;
+    if (!invalidate) return;
+
+    int32_t top = value_to_y(graph, coords, graph->col_max[col]);
+    int32_t bottom = value_to_y(graph, coords, graph->col_min[col]);
+    if (!was_empty && top == old_top && bottom == old_bottom) return;
+
+    lv_area_t area;
+    area.x1 = coords->x1 + col;
+    area.x2 = area.x1;
+    area.y1 = was_empty ? top : LV_MIN(top, old_top);
+    area.y2 = was_empty ? bottom : LV_MAX(bottom, old_bottom);
+    lv_obj_invalidate_area(graph->obj, &area);
+    graph->columns_invalidated++;
+}
+
+void ui_shot_graph_create(ui_shot_graph_t* graph, lv_obj_t* parent, int32_t width, int32_t height,
+                          lv_color_t color) {
+    lv_memzero(graph, sizeof(*graph));
+    graph->width = width;
+    graph->color = color;
+    graph->col_min = (float*)lv_malloc(width * sizeof(float));
+    graph->col_max = (float*)lv_malloc(width * sizeof(float));
+    LV_ASSERT_MALLOC(graph->col_min);
+    LV_ASSERT_MALLOC(graph->col_max);
+    graph->last_col = -1;
+    graph->ms_per_col = UI_SHOT_GRAPH_MS_PER_COL;
+    graph->y_max = UI_SHOT_GRAPH_MIN_Y_MAX;
+    clear_columns(graph, 0);
+
+    graph->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(graph->obj);
+    lv_obj_set_size(graph->obj, width, height);
+    lv_obj_clear_flag(graph->obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(graph->obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(graph->obj, draw_cb, LV_EVENT_DRAW_MAIN, graph);
+}
+
+void ui_shot_graph_begin(ui_shot_graph_t* graph, uint32_t t0_ms, float target) {
+    clear_columns(graph, 0);
+    graph->t0_ms = t0_ms;
+    graph->last_col = -1;
+    graph->last_value = 0;
+    graph->ms_per_col = UI_SHOT_GRAPH_MS_PER_COL;
+    graph->target = target;
+    graph->y_max = LV_MAX(target * UI_SHOT_GRAPH_HEADROOM, UI_SHOT_GRAPH_MIN_Y_MAX);
+    graph->samples = 0;
+    graph->columns_invalidated = 0;
+    graph->full_redraws = 0;
+    lv_obj_invalidate(graph->obj);
+}
+
+void ui_shot_graph_add(ui_shot_graph_t* graph, uint32_t t_ms, float value) {
+    lv_area_t coords;
+    lv_obj_get_coords(graph->obj, &coords);
+    bool full_redraw = false;
+
+    int32_t col = (t_ms > graph->t0_ms) ? (int32_t)((t_ms - graph->t0_ms) / graph->ms_per_col) : 0;
+    while (col >= graph->width) {
+        compress(graph);
+        col /= 2;
+        full_redraw = true;
+    }
+    if (col < graph->last_col) col = graph->last_col; // Out-of-order timestamp
+
+    if (value > graph->y_max) {
+        graph->y_max = value * UI_SHOT_GRAPH_HEADROOM;
+        full_redraw = true;
+    }
+
+    if (graph->last_col < 0) {
+        extend_column(graph, &coords, col, value, !full_redraw);
+    } else {
+        // Connect to the previous sample: interpolate skipped columns, then span prev..value
+        int32_t gap = col - graph->last_col;
+        for (int32_t c = graph->last_col + 1; c < col; c++) {
+            float v = graph->last_value + (value - graph->last_value) * (c - graph->last_col) / gap;
+            extend_column(graph, &coords, c, v, !full_redraw);
+        }
+        if (col != graph->last_col) extend_column(graph, &coords, col, graph->last_value, !full_redraw);
+        extend_column(graph, &coords, col, value, !full_redraw);
+    }
+
+    graph->last_col = col;
+    graph->last_value = value;
+    graph->samples++;
+    if (full_redraw) {
+        lv_obj_invalidate(graph->obj);
+        graph->full_redraws++;
+    }
+}
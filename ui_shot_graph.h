@@ -0,0 +1,55 @@
+/*
+ * Header for the live shot graph widget.
+ *
+ * Plots weight against time during a shot. Samples are decimated into one
+ * min/max pair per pixel column; when a shot outlasts the width, adjacent
+ * columns are merged and the time scale doubles, so any shot length fits.
+ * Appending a sample invalidates only the column it lands in, and only the
+ * rows whose pixels changed.
+ */
+#ifndef UI_SHOT_GRAPH_H
+#define UI_SHOT_GRAPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#define UI_SHOT_GRAPH_MS_PER_COL 100 // Initial time per column; doubles as needed
+
+typedef struct {
+    lv_obj_t* obj;                  // Plot area, align/size like any object
+    float* col_min;                 // Per-column minimum (width entries, allocated once)
+    float* col_max;                 // Per-column maximum; col_min > col_max = empty
+    int32_t width;                  // Number of columns (object width in px)
+    uint32_t ms_per_col;
+    uint32_t t0_ms;                 // Timestamp of the series start
+    int32_t last_col;               // Column of the previous sample, -1 before the first
+    float last_value;
+    float y_max;                    // Value at the top edge
+    float target;                   // Horizontal reference line, <= 0 to hide
+    lv_color_t color;
+    uint32_t samples;               // Stats: samples added this series
+    uint32_t columns_invalidated;   // Stats: single-column invalidations
+    uint32_t full_redraws;          // Stats: rescales that invalidated the whole plot
+} ui_shot_graph_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates the plot under parent with a fixed size. The column buffers are allocated here.
+void ui_shot_graph_create(ui_shot_graph_t* graph, lv_obj_t* parent, int32_t width, int32_t height,
+                          lv_color_t color);
+
+// Clears the plot and starts a new series at t0_ms. target sets the reference line and
+// the initial vertical scale.
+void ui_shot_graph_begin(ui_shot_graph_t* graph, uint32_t t0_ms, float target);
+
+// Appends one sample taken at t_ms (same clock as t0_ms).
+void ui_shot_graph_add(ui_shot_graph_t* graph, uint32_t t_ms, float value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_SHOT_GRAPH_H
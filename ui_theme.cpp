@@ -0,0 +1,148 @@
+/*
+ * UI theme modes implementation.
+ *
+ * LITE styles are LV_STYLE_CONST_INIT tables: they live in flash, cost no
+ * heap and are never rebuilt. Buttons get lv_obj_remove_style_all() first,
+ * so none of the default theme's radius, shadow, gradient or transition
+ * properties reach the draw pipeline; what is left is a 2 px border
+ * (four rectangle fills) and the label.
+ */
+
+#include "ui_theme.h"
+#include "lcd_config.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+static ui_theme_mode_t theme_mode = UI_THEME_DEFAULT;
+
+// --- LITE styles (flash) ---
+static const lv_style_const_prop_t lite_screen_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(lite_screen, lite_screen_props);
+
+static const lv_style_const_prop_t lite_button_props[] = {
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x50, 0x50, 0x50)),
+    LV_STYLE_CONST_BORDER_WIDTH(2),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(lite_button, lite_button_props);
+
+static const lv_style_const_prop_t lite_button_pressed_props[] = {
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(lite_button_pressed, lite_button_pressed_props);
+
+static const lv_style_const_prop_t lite_button_checked_props[] = {
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x28, 0xA7, 0x45)),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x28, 0xA7, 0x45)),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(lite_button_checked, lite_button_checked_props);
+
+// Same highlight as the old runtime-built style_selected
+static const lv_style_const_prop_t selected_props[] = {
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x89, 0xCF, 0xF0)),
+    LV_STYLE_CONST_BORDER_WIDTH(3),
+    LV_STYLE_CONST_BORDER_SIDE(LV_BORDER_SIDE_FULL),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(selected_style, selected_props);
+
+// Knob focus is shown with selected_style only, not the default theme's outlines
+static const lv_style_const_prop_t no_outline_props[] = {
+    LV_STYLE_CONST_OUTLINE_WIDTH(0),
+    LV_STYLE_CONST_PROPS_END
+};
+static LV_STYLE_CONST_INIT(no_outline_style, no_outline_props);
+
+void ui_theme_init(ui_theme_mode_t mode) {
+    theme_mode = (mode == UI_THEME_STANDARD) ? UI_THEME_STANDARD : UI_THEME_LITE;
+    Serial.printf("UI theme: %s\n", ui_theme_name());
+}
+
+ui_theme_mode_t ui_theme_get_mode(void) {
+    return theme_mode;
+}
+
+const char* ui_theme_name(void) {
+    return theme_mode == UI_THEME_LITE ? "lite" : "standard";
+}
+
+void ui_theme_style_screen(lv_obj_t* screen, lv_color_t standard_bg) {
+    if (theme_mode == UI_THEME_LITE) {
+        lv_obj_add_style(screen, &lite_screen, LV_PART_MAIN);
+    } else {
+        lv_obj_set_style_bg_color(screen, standard_bg, LV_PART_MAIN);
+    }
+}
+
+bool ui_theme_style_button(lv_obj_t* btn) {
+    if (theme_mode != UI_THEME_LITE) return false;
+    lv_obj_remove_style_all(btn);
+    lv_obj_add_style(btn, &lite_button, LV_PART_MAIN);
+    lv_obj_add_style(btn, &lite_button_pressed, LV_PART_MAIN | LV_STATE_PRESSED);
+    lv_obj_add_style(btn, &lite_button_checked, LV_PART_MAIN | LV_STATE_CHECKED);
+    return true;
+}
+
+void ui_theme_style_focusable(lv_obj_t* obj, bool highlight) {
+    lv_obj_add_style(obj, &no_outline_style, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_add_style(obj, &no_outline_style, LV_PART_MAIN | LV_STATE_EDITED);
+    if (highlight) lv_obj_add_style(obj, &selected_style, LV_PART_MAIN | LV_STATE_FOCUSED);
+}
+
+bool ui_theme_measure_screen(lv_obj_t* screen, ui_theme_measure_t* out) {
+#if LV_USE_SNAPSHOT
+    if (screen == NULL) return false;
+    uint32_t stride = lv_draw_buf_width_to_stride(EXAMPLE_LCD_H_RES, LV_COLOR_FORMAT_RGB565);
+    uint32_t size = stride * EXAMPLE_LCD_V_RES;
+    void* data = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, size, MALLOC_CAP_SPIRAM);
+    if (data == NULL) return false;
+
+    lv_draw_buf_t buf;
+    lv_draw_buf_init(&buf, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, LV_COLOR_FORMAT_RGB565, stride, data, size);
+    int64_t start_us = esp_timer_get_time();
+    lv_result_t res = lv_snapshot_take_to_draw_buf(screen, LV_COLOR_FORMAT_RGB565, &buf);
+    out->render_us = (uint32_t)(esp_timer_get_time() - start_us);
+    if (res != LV_RESULT_OK) {
+        heap_caps_free(data);
+        return false;
+    }
+
+    // Only the pixels inside the round panel count
+    const int32_t r = EXAMPLE_LCD_H_RES / 2;
+    uint64_t drive = 0;
+    out->lit_pixels = 0;
+    out->total_pixels = 0;
+    for (int32_t y = 0; y < EXAMPLE_LCD_V_RES; y++) {
+        const uint16_t* row = (const uint16_t*)((const uint8_t*)data + y * stride);
+        int32_t dy = y - r;
+        for (int32_t x = 0; x < EXAMPLE_LCD_H_RES; x++) {
+            int32_t dx = x - r;
+            if (dx * dx + dy * dy > r * r) continue;
+            uint16_t c = row[x];
+            out->total_pixels++;
+            if (c == 0) continue;
+            out->lit_pixels++;
+            // Scale the 5/6/5-bit channels to 0-255 and sum them
+            drive += ((c >> 11) & 0x1F) * 255 / 31 + ((c >> 5) & 0x3F) * 255 / 63 + (c & 0x1F) * 255 / 31;
+        }
+    }
+    out->emission_pct = out->total_pixels ? (uint8_t)(drive * 100 / ((uint64_t)out->total_pixels * 3 * 255)) : 0;
+    heap_caps_free(data);
+    return true;
+#else
+    (void)screen;
+    (void)out;
+    return false;
+#endif
+}
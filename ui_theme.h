@@ -0,0 +1,65 @@
+/*
+ * Header for the UI theme modes.
+ *
+ * STANDARD is the look the screens always had: LVGL's default theme with
+ * filled, rounded buttons and a grey HA background. LITE is meant for the
+ * AMOLED, where every lit pixel costs power: true-black backgrounds, buttons
+ * drawn as thin outlines with no fill, radius, shadow or gradient, and
+ * styles that are static const (flash) instead of built at runtime.
+ *
+ * The mode is chosen at boot (stored in NVS, see app_poll_serial 't').
+ * ui_theme_measure_screen() renders a screen offscreen and reports its
+ * lit-pixel ratio and render time so the two modes can be compared.
+ */
+#ifndef UI_THEME_H
+#define UI_THEME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#define UI_THEME_DEFAULT UI_THEME_STANDARD // Used until a mode is stored in NVS
+#define UI_THEME_NVS_KEY "theme"
+
+typedef enum {
+    UI_THEME_STANDARD = 0,
+    UI_THEME_LITE = 1
+} ui_theme_mode_t;
+
+typedef struct {
+    uint32_t render_us;     // Full-screen offscreen render
+    uint32_t lit_pixels;    // Pixels that are not pure black
+    uint32_t total_pixels;
+    uint8_t emission_pct;   // Mean sub-pixel drive level, 0-100 (rough AMOLED power proxy)
+} ui_theme_measure_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Selects the mode. Call before any screen is built.
+void ui_theme_init(ui_theme_mode_t mode);
+ui_theme_mode_t ui_theme_get_mode(void);
+const char* ui_theme_name(void);
+
+// Screen background: standard_bg in STANDARD, black in LITE
+void ui_theme_style_screen(lv_obj_t* screen, lv_color_t standard_bg);
+
+// LITE: replaces the default theme styles with the outline button style and
+// returns true. STANDARD: leaves the button alone and returns false, so the
+// caller applies its usual fill/radius. Call right after creating the button:
+// in LITE it removes every style, including a size or position set before.
+bool ui_theme_style_button(lv_obj_t* btn);
+
+// Styles an object in a knob group: no default-theme focus/edit outlines and,
+// if highlight is set, the selected border while it has focus.
+void ui_theme_style_focusable(lv_obj_t* obj, bool highlight);
+
+// Renders screen into a temporary PSRAM buffer and measures it (LVGL task only).
+bool ui_theme_measure_screen(lv_obj_t* screen, ui_theme_measure_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_THEME_H
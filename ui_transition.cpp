@@ -0,0 +1,204 @@
+/*
+ * Snapshot-cached screen transition implementation.
+ *
+ * Two snapshot slots are kept in PSRAM, one per screen. The destination
+ * screen's snapshot is reused while it is clean (see ui_transition_mark_dirty),
+ * the source screen is always re-snapshotted since it is what is on the
+ * panel right now. During the slide a dedicated "stage" screen shows the two
+ * snapshots as images and moves them; on landing the real destination screen
+ * is loaded without animation so its live widgets render exactly once.
+ *
+ * Requires LV_USE_SNAPSHOT in lv_conf.h; without it the engine falls back to
+ * lv_scr_load_anim().
+ */
+
+#include "ui_transition.h"
+#include "lcd_config.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+#define UI_TRANSITION_SLOTS 2
+
+typedef struct {
+    lv_obj_t* screen;   // Screen this slot holds, NULL if unused
+    lv_draw_buf_t buf;
+    void* data;         // PSRAM pixel storage
+    bool valid;         // Snapshot matches the screen's current state
+} snapshot_slot_t;
+
+static snapshot_slot_t slots[UI_TRANSITION_SLOTS];
+static bool snapshots_available = false;
+
+static lv_obj_t* stage = NULL;       // Screen used while sliding
+static lv_obj_t* stage_from = NULL;  // Image of the outgoing screen
+static lv_obj_t* stage_to = NULL;    // Image of the incoming screen
+static lv_obj_t* target_screen = NULL;
+static lv_dir_t slide_dir = LV_DIR_TOP;
+static bool running = false;
+
+// Stats for the current/last transition
+static int64_t start_us = 0;
+static int64_t landed_us = 0;
+static uint32_t slide_frames = 0;
+static bool awaiting_first_live_frame = false;
+
+static void stage_anim_cb(void* var, int32_t v) {
+    // v runs 0 -> V_RES; both images move together
+    int32_t offset = (slide_dir == LV_DIR_TOP) ? -v : v;
+    lv_obj_set_y(stage_from, offset);
+    lv_obj_set_y(stage_to, offset + ((slide_dir == LV_DIR_TOP) ? EXAMPLE_LCD_V_RES : -EXAMPLE_LCD_V_RES));
+}
+
+static void stage_anim_ready_cb(lv_anim_t* a) {
+    landed_us = esp_timer_get_time();
+    awaiting_first_live_frame = true;
+    lv_screen_load(target_screen); // Live widgets render once, here
+    running = false;
+}
+
+static void display_refr_ready_cb(lv_event_t* e) {
+    if (running) {
+        slide_frames++;
+    } else if (awaiting_first_live_frame) {
+        awaiting_first_live_frame = false;
+        int64_t now_us = esp_timer_get_time();
+        float slide_s = (float)(landed_us - start_us) / 1000000.0f;
+        Serial.printf("Transition: %lu frames in %.0f ms (%.1f fps), interactive after %lu ms\n",
+                      (unsigned long)slide_frames, slide_s * 1000.0f,
+                      slide_s > 0 ? (float)slide_frames / slide_s : 0.0f,
+                      (unsigned long)((now_us - start_us) / 1000));
+    }
+}
+
+void ui_transition_init(void) {
+    lv_display_add_event_cb(lv_display_get_default(), display_refr_ready_cb, LV_EVENT_REFR_READY, NULL);
+
+#if LV_USE_SNAPSHOT
+    uint32_t stride = lv_draw_buf_width_to_stride(EXAMPLE_LCD_H_RES, LV_COLOR_FORMAT_RGB565);
+    uint32_t size = stride * EXAMPLE_LCD_V_RES;
+    for (int i = 0; i < UI_TRANSITION_SLOTS; i++) {
+        slots[i].data = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, size, MALLOC_CAP_SPIRAM);
+        if (slots[i].data == NULL) {
+            // Both slots or none: give back what was already reserved
+            for (int j = 0; j < i; j++) {
+                heap_caps_free(slots[j].data);
+                slots[j].data = NULL;
+            }
+            Serial.println("Transition: no PSRAM for snapshots, using live screen animation.");
+            return;
+        }
+        lv_draw_buf_init(&slots[i].buf, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, LV_COLOR_FORMAT_RGB565,
+                         stride, slots[i].data, size);
+    }
+
+    stage = lv_obj_create(NULL);
+    lv_obj_remove_style_all(stage);
+    lv_obj_set_style_bg_color(stage, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(stage, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(stage, LV_OBJ_FLAG_SCROLLABLE);
+    stage_from = lv_image_create(stage);
+    stage_to = lv_image_create(stage);
+
+    snapshots_available = true;
+    Serial.printf("Transition: %lu bytes of PSRAM reserved for snapshots.\n",
+                  (unsigned long)(size * UI_TRANSITION_SLOTS));
+#endif
+}
+
+void ui_transition_mark_dirty(lv_obj_t* screen) {
+    if (screen == NULL) return;
+    for (int i = 0; i < UI_TRANSITION_SLOTS; i++) {
+        if (slots[i].screen == screen) {
+            slots[i].valid = false;
+        }
+    }
+}
+
+void ui_transition_forget(lv_obj_t* screen) {
+    if (screen == NULL) return;
+    for (int i = 0; i < UI_TRANSITION_SLOTS; i++) {
+        if (slots[i].screen == screen) {
+            slots[i].screen = NULL;
+            slots[i].valid = false;
+        }
+    }
+}
+
+bool ui_transition_is_running(void) {
+    return running;
+}
+
+#if LV_USE_SNAPSHOT
+// Returns an up-to-date snapshot of screen, re-rendering only if needed.
+// `exclude` is a slot that must not be evicted (the other half of the transition).
+static lv_draw_buf_t* snapshot_of(lv_obj_t* screen, bool force, const snapshot_slot_t* exclude) {
+    snapshot_slot_t* slot = NULL;
+    for (int i = 0; i < UI_TRANSITION_SLOTS; i++) {
+        if (slots[i].screen == screen) slot = &slots[i];
+    }
+    if (slot == NULL) {
+        for (int i = 0; i < UI_TRANSITION_SLOTS && slot == NULL; i++) {
+            if (&slots[i] != exclude) slot = &slots[i];
+        }
+        slot->screen = screen;
+        slot->valid = false;
+    }
+    if (force || !slot->valid) {
+        lv_obj_update_layout(screen); // Screens that were never shown have no layout yet
+        if (lv_snapshot_take_to_draw_buf(screen, LV_COLOR_FORMAT_RGB565, &slot->buf) != LV_RESULT_OK) {
+            slot->screen = NULL;
+            return NULL;
+        }
+        lv_image_cache_drop(&slot->buf); // Buffer contents changed under the same pointer
+        slot->valid = true;
+    }
+    return &slot->buf;
+}
+#endif
+
+void ui_transition_start(lv_obj_t* to, lv_dir_t dir, uint32_t duration_ms) {
+    lv_obj_t* from = lv_screen_active();
+    if (running || to == NULL || to == from) return;
+
+    start_us = esp_timer_get_time();
+    slide_frames = 0;
+
+#if LV_USE_SNAPSHOT
+    if (snapshots_available) {
+        lv_draw_buf_t* from_buf = snapshot_of(from, true, NULL);
+        snapshot_slot_t* from_slot = NULL;
+        for (int i = 0; i < UI_TRANSITION_SLOTS; i++) {
+            if (slots[i].screen == from) from_slot = &slots[i];
+        }
+        lv_draw_buf_t* to_buf = from_buf ? snapshot_of(to, false, from_slot) : NULL;
+        if (from_buf && to_buf) {
+            lv_image_set_src(stage_from, from_buf);
+            lv_image_set_src(stage_to, to_buf);
+            slide_dir = dir;
+            target_screen = to;
+            running = true;
+            stage_anim_cb(NULL, 0);
+            lv_screen_load(stage);
+
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_var(&a, stage);
+            lv_anim_set_exec_cb(&a, stage_anim_cb);
+            lv_anim_set_values(&a, 0, EXAMPLE_LCD_V_RES);
+            lv_anim_set_duration(&a, duration_ms);
+            lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+            lv_anim_set_ready_cb(&a, stage_anim_ready_cb);
+            lv_anim_start(&a);
+            return;
+        }
+        Serial.println("Transition: snapshot failed, using live screen animation.");
+    }
+#endif
+
+    // Fallback: LVGL's built-in animation renders both screens live
+    lv_scr_load_anim(to, dir == LV_DIR_TOP ? LV_SCR_LOAD_ANIM_MOVE_TOP : LV_SCR_LOAD_ANIM_MOVE_BOTTOM,
+                     duration_ms, 0, false);
+    landed_us = start_us + (int64_t)duration_ms * 1000;
+    awaiting_first_live_frame = false;
+}
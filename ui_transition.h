@@ -0,0 +1,39 @@
+/*
+ * Header for the snapshot-cached screen transition engine.
+ *
+ * Swiping between screens slides two pre-rendered snapshots (kept in PSRAM)
+ * instead of rendering both live widget trees on every animation frame.
+ * The destination screen is only rendered live once the slide has landed.
+ */
+#ifndef UI_TRANSITION_H
+#define UI_TRANSITION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocates the snapshot buffers. Falls back to plain lv_scr_load_anim() if PSRAM is unavailable.
+void ui_transition_init(void);
+
+// Marks the cached snapshot of a screen as stale (its widgets changed).
+void ui_transition_mark_dirty(lv_obj_t* screen);
+
+// Releases a screen's snapshot slot, e.g. before the screen is deleted.
+void ui_transition_forget(lv_obj_t* screen);
+
+// Slides from the active screen to `to`. dir is the direction the content moves:
+// LV_DIR_TOP (new screen comes up from the bottom) or LV_DIR_BOTTOM.
+void ui_transition_start(lv_obj_t* to, lv_dir_t dir, uint32_t duration_ms);
+
+// True while a slide is in progress (further swipes are ignored).
+bool ui_transition_is_running(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_TRANSITION_H